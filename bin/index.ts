@@ -1 +1,3 @@
-console.log("Hello via Bun!");
\ No newline at end of file
+import cli from '../core/cli.ts';
+
+await cli.main(process.argv.slice(2));
@@ -0,0 +1,194 @@
+/**
+ * GitZipQR — APNG writer/reader
+ * Animated output for screen-to-camera transfer: every frame is a full-size
+ * 8-bit grayscale image (offset 0, no blending), so each one stays a complete
+ * QR on its own and the reader can hand frames to the decoder independently.
+ * Also writes plain grayscale PNGs (used by the grid symbology) and decodes
+ * gray-looking PNGs straight to one byte per pixel for the decode worker.
+ */
+const fs = require('fs');
+const zlib = require('zlib');
+
+const SIGNATURE = Buffer.from('89504e470d0a1a0a', 'hex');
+
+const CRC_TABLE = (() => {
+  const t = new Uint32Array(256);
+  for (let n = 0; n < 256; n++) {
+    let c = n;
+    for (let k = 0; k < 8; k++) c = c & 1 ? 0xedb88320 ^ (c >>> 1) : c >>> 1;
+    t[n] = c >>> 0;
+  }
+  return t;
+})();
+function crcUpdate(buf, crc = 0xffffffff) {
+  for (let i = 0; i < buf.length; i++) crc = CRC_TABLE[(crc ^ buf[i]) & 0xff] ^ (crc >>> 8);
+  return crc;
+}
+function crc32(buf) { return (crcUpdate(buf) ^ 0xffffffff) >>> 0; }
+
+function chunk(type, data) {
+  const head = Buffer.alloc(8);
+  head.writeUInt32BE(data.length, 0); head.write(type, 4, 'ascii');
+  const tail = Buffer.alloc(4);
+  tail.writeUInt32BE((crcUpdate(data, crcUpdate(head.subarray(4))) ^ 0xffffffff) >>> 0, 0);
+  return Buffer.concat([head, data, tail]);
+}
+function u32s(...values) {
+  const b = Buffer.alloc(values.length * 4);
+  values.forEach((v, i) => b.writeUInt32BE(v >>> 0, i * 4));
+  return b;
+}
+function ihdr(width, height) {
+  return Buffer.concat([u32s(width, height), Buffer.from([8, 0, 0, 0, 0])]); // 8-bit gray
+}
+
+/** gray: Uint8Array(width * height), one byte per pixel. */
+function deflateGray(gray, width, height, level = 9) {
+  const raw = Buffer.alloc((width + 1) * height);
+  for (let y = 0; y < height; y++) {
+    raw[y * (width + 1)] = 0; // filter: none
+    raw.set(gray.subarray(y * width, (y + 1) * width), y * (width + 1) + 1);
+  }
+  return zlib.deflateSync(raw, { level });
+}
+
+/** Single-frame 8-bit grayscale PNG. */
+function encodeGrayPng(width, height, gray, level = 9) {
+  return Buffer.concat([SIGNATURE, chunk('IHDR', ihdr(width, height)), chunk('IDAT', deflateGray(gray, width, height, level)), chunk('IEND', Buffer.alloc(0))]);
+}
+
+function paeth(a, b, c) {
+  const p = a + b - c, pa = Math.abs(p - a), pb = Math.abs(p - b), pc = Math.abs(p - c);
+  return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+// Reverses the per-row filters in place; raw holds height rows of 1 + stride bytes.
+function unfilter(raw, stride, height, bpp) {
+  for (let y = 0; y < height; y++) {
+    const row = y * (stride + 1) + 1, prev = row - stride - 1, type = raw[row - 1];
+    for (let x = 0; x < stride; x++) {
+      const a = x >= bpp ? raw[row + x - bpp] : 0, b = y ? raw[prev + x] : 0, c = y && x >= bpp ? raw[prev + x - bpp] : 0;
+      const pred = type === 1 ? a : type === 2 ? b : type === 3 ? (a + b) >> 1 : type === 4 ? paeth(a, b, c) : 0;
+      raw[row + x] = (raw[row + x] + pred) & 0xff;
+    }
+  }
+}
+
+/**
+ * Non-interlaced gray, gray+alpha, palette, RGB or RGBA PNG -> { gray, width, height }
+ * (alpha ignored, as the QR reader does), with gray from alloc(bytes). Returns null
+ * when a pixel is not gray (RGB-multiplexed symbols) or the format is not covered
+ * (16-bit, interlaced); the caller then uses a full RGBA decoder.
+ */
+function decodePngGray(buf, alloc = (n) => new Uint8Array(n)) {
+  if (!buf.subarray(0, 8).equals(SIGNATURE)) return null;
+  let width = 0, height = 0, depth = 0, type = 0, palette = null;
+  const idat = [];
+  for (let off = 8; off + 8 <= buf.length;) {
+    const len = buf.readUInt32BE(off), kind = buf.toString('ascii', off + 4, off + 8);
+    const data = buf.subarray(off + 8, off + 8 + len);
+    off += 12 + len;
+    if (kind === 'IHDR') {
+      width = data.readUInt32BE(0); height = data.readUInt32BE(4); depth = data[8]; type = data[9];
+      if (data[12] || depth > 8 || ((type === 2 || type === 4 || type === 6) && depth !== 8)) return null;
+    } else if (kind === 'PLTE') palette = data;
+    else if (kind === 'IDAT') idat.push(data);
+    else if (kind === 'acTL') return null; // animated: readApngFrames
+    else if (kind === 'IEND') break;
+  }
+  const channels = { 0: 1, 2: 3, 3: 1, 4: 2, 6: 4 }[type];
+  if (!width || !channels || (type === 3 && !palette)) return null;
+  if (palette) for (let i = 0; i < palette.length; i += 3) if (palette[i] !== palette[i + 1] || palette[i] !== palette[i + 2]) return null;
+  const stride = Math.ceil((width * channels * depth) / 8), bpp = Math.max(1, (channels * depth) >> 3);
+  const raw = zlib.inflateSync(idat.length === 1 ? idat[0] : Buffer.concat(idat));
+  if (raw.length < (stride + 1) * height) throw new Error('PNG data is truncated');
+  unfilter(raw, stride, height, bpp);
+  const gray = alloc(width * height);
+  const max = (1 << depth) - 1;
+  for (let y = 0; y < height; y++) {
+    const row = y * (stride + 1) + 1, out = y * width;
+    if (depth < 8) {
+      for (let x = 0; x < width; x++) {
+        const bit = x * depth, v = (raw[row + (bit >> 3)] >> (8 - depth - (bit & 7))) & max;
+        gray[out + x] = type === 3 ? palette[v * 3] : (v * 255) / max;
+      }
+    } else if (type === 0) gray.set(raw.subarray(row, row + width), out);
+    else if (type === 3) for (let x = 0; x < width; x++) gray[out + x] = palette[raw[row + x] * 3];
+    else if (type === 4) for (let x = 0; x < width; x++) gray[out + x] = raw[row + 2 * x];
+    else {
+      for (let x = 0, i = row; x < width; x++, i += channels) {
+        if (raw[i] !== raw[i + 1] || raw[i] !== raw[i + 2]) return null;
+        gray[out + x] = raw[i];
+      }
+    }
+  }
+  return { gray, width, height };
+}
+
+/**
+ * Streams an APNG to outPath. frameAt(i) -> { gray } (width * height bytes) is
+ * called for each of the `count` frames in turn; delay per frame is 1/fps s, looping forever.
+ */
+async function writeApng(outPath, count, width, height, fps, frameAt) {
+  const fd = fs.openSync(outPath, 'w');
+  try {
+    fs.writeSync(fd, Buffer.concat([SIGNATURE, chunk('IHDR', ihdr(width, height)), chunk('acTL', u32s(count, 0))]));
+    let seq = 0;
+    for (let i = 0; i < count; i++) {
+      const { gray } = await frameAt(i);
+      // fcTL: seq, size, offset 0/0, delay 1/fps, dispose none, blend source
+      const fctl = Buffer.concat([u32s(seq++, width, height, 0, 0), Buffer.alloc(6)]);
+      fctl.writeUInt16BE(1, 20); fctl.writeUInt16BE(fps, 22);
+      const z = deflateGray(gray, width, height);
+      const body = i === 0 ? chunk('IDAT', z) : chunk('fdAT', Buffer.concat([u32s(seq++), z]));
+      fs.writeSync(fd, Buffer.concat([chunk('fcTL', fctl), body]));
+    }
+    fs.writeSync(fd, chunk('IEND', Buffer.alloc(0)));
+  } finally {
+    fs.closeSync(fd);
+  }
+}
+
+function isAnimatedPng(filePath) {
+  const fd = fs.openSync(filePath, 'r');
+  try {
+    const head = Buffer.alloc(64);
+    const n = fs.readSync(fd, head, 0, head.length, 0);
+    return n > 41 && head.subarray(0, 8).equals(SIGNATURE) && head.subarray(0, n).includes('acTL');
+  } finally {
+    fs.closeSync(fd);
+  }
+}
+
+/**
+ * Splits an APNG into standalone PNGs (one per frame). Frames are returned as
+ * Uint8Arrays that own their buffer, so they can be transferred to workers.
+ */
+function readApngFrames(buf) {
+  if (!buf.subarray(0, 8).equals(SIGNATURE)) throw new Error('Not a PNG file');
+  let header = null, frame = null;
+  const frames = [], shared = []; // PLTE/tRNS apply to every frame
+  const flush = () => {
+    if (!frame || !frame.data.length) return;
+    const ihdrData = Buffer.from(header);
+    ihdrData.writeUInt32BE(frame.width, 0); ihdrData.writeUInt32BE(frame.height, 4);
+    const png = Buffer.concat([SIGNATURE, chunk('IHDR', ihdrData), ...shared, chunk('IDAT', Buffer.concat(frame.data)), chunk('IEND', Buffer.alloc(0))]);
+    const out = new Uint8Array(png.length); out.set(png);
+    frames.push(out);
+  };
+  for (let off = 8; off + 8 <= buf.length;) {
+    const len = buf.readUInt32BE(off), type = buf.toString('ascii', off + 4, off + 8);
+    const data = buf.subarray(off + 8, off + 8 + len);
+    off += 12 + len;
+    if (type === 'IHDR') { header = data; frame = { width: data.readUInt32BE(0), height: data.readUInt32BE(4), data: [] }; }
+    else if (type === 'fcTL') { flush(); frame = { width: data.readUInt32BE(4), height: data.readUInt32BE(8), data: [] }; }
+    else if (type === 'PLTE' || type === 'tRNS') shared.push(chunk(type, data));
+    else if (type === 'IDAT') frame.data.push(data);
+    else if (type === 'fdAT') frame.data.push(data.subarray(4));
+    else if (type === 'IEND') break;
+  }
+  flush();
+  return frames;
+}
+
+module.exports = { writeApng, readApngFrames, isAnimatedPng, encodeGrayPng, decodePngGray, crc32, crcUpdate };
@@ -0,0 +1,56 @@
+/**
+ * GitZipQR — per-worker scratch buffers
+ * A persistent decode worker sees thousands of images of nearly the same size,
+ * so file bytes, pixel planes and coefficient blocks are carved from a few
+ * long-lived buffers instead of being allocated (and collected) per image.
+ *
+ * take(slot, bytes) returns a view of exactly `bytes` over the slot's backing
+ * store, sized to the next power of two and replaced only when a larger request
+ * arrives. A view is valid until the next take() of the same slot, so nothing
+ * from here may outlive the task (results are copied by postMessage anyway).
+ */
+const fs = require('fs');
+
+const MIN_CLASS = 1 << 16;
+const slots = new Map();
+
+function sizeClass(bytes) {
+  let n = MIN_CLASS;
+  while (n < bytes) n *= 2;
+  return n;
+}
+
+function take(slot, bytes) {
+  let buf = slots.get(slot);
+  if (!buf || buf.length < bytes) {
+    buf = Buffer.allocUnsafeSlow(sizeClass(bytes));
+    slots.set(slot, buf);
+  }
+  return buf.subarray(0, bytes);
+}
+
+/** Zero-filled typed array of `length` elements from a slot. */
+function typed(slot, Type, length) {
+  const buf = take(slot, length * Type.BYTES_PER_ELEMENT);
+  return new Type(buf.buffer, buf.byteOffset, length).fill(0);
+}
+
+/** Whole file into the slot's buffer. */
+function readFile(filePath, slot = 'file') {
+  const fd = fs.openSync(filePath, 'r');
+  try {
+    const size = fs.fstatSync(fd).size;
+    const buf = take(slot, size);
+    let off = 0;
+    while (off < size) {
+      const n = fs.readSync(fd, buf, off, size - off, off);
+      if (!n) break;
+      off += n;
+    }
+    return buf.subarray(0, off);
+  } finally {
+    fs.closeSync(fd);
+  }
+}
+
+module.exports = { take, typed, readFile };
@@ -0,0 +1,154 @@
+/**
+ * GitZipQR — Benchmarks
+ * Usage: bun run bench [suite ...]   (default: every suite)
+ *
+ *   symbology  round trip of BENCH_N full-size symbols per backend (core/symbology.ts)
+ *              through the same worker pools encode/decode use; reports payload
+ *              bytes per pixel, PNG bytes per payload byte and MB/s each way.
+ *   binarize   luma + adaptive threshold (shared/binarize.js): WASM SIMD kernel vs
+ *              the scalar version, and jsQR on the raw image (its own binarizer,
+ *              both polarities) vs jsQR on the kernel's output (one polarity).
+ *   hash       archive hashing (core/hash.ts) over BENCH_MB of random bytes:
+ *              SHA-256, BLAKE3 scalar / WASM SIMD on one core, BLAKE3 on the hash workers.
+ *
+ * BENCH_N (default 64) sets the sample size, QR_WORKERS the pool size, BENCH_MB (default 64) the hash input.
+ */
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const crypto = require('crypto');
+const { WorkerPool, workerPath } = require('./pool');
+const symbology = require('./symbology');
+const { FRAGMENT_TYPE, encodeFrame, frameOverhead } = require('../shared/frame');
+
+const BENCH_N = Math.max(1, parseInt(process.env.BENCH_N || '64', 10));
+const MAX_WORKERS = Math.max(1, parseInt(process.env.QR_WORKERS || String(os.cpus().length), 10));
+const ECL = (process.env.QR_ECL || 'L').toUpperCase();
+
+const mbps = (bytes, ms) => (bytes / 1048576 / (ms / 1000)).toFixed(2);
+function pngPixels(file) {
+  const head = Buffer.alloc(24);
+  const fd = fs.openSync(file, 'r'); fs.readSync(fd, head, 0, 24, 0); fs.closeSync(fd);
+  return head.readUInt32BE(16) * head.readUInt32BE(20);
+}
+
+async function benchSymbology() {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'gitzipqr-bench-'));
+  const enc = new WorkerPool(workerPath('qr.worker.ts'), MAX_WORKERS);
+  const dec = new WorkerPool(workerPath('qrdecode.worker.ts'), MAX_WORKERS);
+  try {
+    console.log(`symbology: ${BENCH_N} symbols each, ECL=${ECL}, workers=${MAX_WORKERS}`);
+    console.log('backend  payload/symbol  bytes/pixel  png/payload  encode MB/s  decode MB/s  ok');
+    for (const name of symbology.names) {
+      const meta = { type: FRAGMENT_TYPE, bench: name, chunk: 999999 };
+      const size = Math.floor((symbology.get(name).capacity({ version: 40, ecl: ECL }) - frameOverhead(meta)) * 0.98);
+      const payloads = Array.from({ length: BENCH_N }, (_, i) => encodeFrame({ ...meta, chunk: i }, crypto.randomBytes(size)));
+      const files = payloads.map((_, i) => path.join(dir, `${name}-${i}.png`));
+
+      let t0 = Date.now();
+      const rendered = await Promise.all(payloads.map((data, i) => enc.run({
+        outPath: files[i], data, symbology: name, useQrencode: false, ecl: ECL, margin: 1,
+      })));
+      const encodeMs = Date.now() - t0;
+      if (rendered.some(r => !r.ok)) throw new Error(`${name}: ${rendered.find(r => !r.ok).error}`);
+
+      t0 = Date.now();
+      const read = await Promise.all(files.map(img => dec.run({ img })));
+      const decodeMs = Date.now() - t0;
+      const ok = read.filter((r, i) => r.ok && r.meta.chunk === i && Buffer.compare(Buffer.from(r.data), Buffer.from(payloads[i].subarray(payloads[i].length - size))) === 0).length;
+
+      const total = size * BENCH_N;
+      const pixels = files.reduce((n, f) => n + pngPixels(f), 0);
+      const pngBytes = files.reduce((n, f) => n + fs.statSync(f).size, 0);
+      console.log([
+        name.padEnd(8), String(size).padStart(14), (total / pixels).toFixed(4).padStart(12),
+        (pngBytes / total).toFixed(2).padStart(12), mbps(total, encodeMs).padStart(12), mbps(total, decodeMs).padStart(12),
+        `${ok}/${BENCH_N}`.padStart(5),
+      ].join(' '));
+    }
+  } finally {
+    await Promise.all([enc.destroy(), dec.destroy()]);
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+}
+
+// Unevenly lit v40 symbol (4 px modules) with a gray margin, as RGBA.
+function litSymbol(size = 1200) {
+  const qrcode = require('qrcode');
+  const { modules } = qrcode.create([{ data: crypto.randomBytes(2000), mode: 'byte' }], { errorCorrectionLevel: 'L' });
+  const rgba = new Uint8ClampedArray(size * size * 4), off = (size - modules.size * 4) >> 1;
+  for (let y = 0; y < size; y++) for (let x = 0; x < size; x++) {
+    const r = ((y - off) / 4) | 0, c = ((x - off) / 4) | 0;
+    const dark = r >= 0 && c >= 0 && r < modules.size && c < modules.size && modules.data[r * modules.size + c];
+    const v = dark ? 20 + (x * 60) / size : 250 - (y * 90) / size;
+    rgba.set([v, v, v, 255], (y * size + x) * 4);
+  }
+  return { data: rgba, width: size, height: size };
+}
+
+async function benchBinarize() {
+  const binarize = require('../shared/binarize');
+  const jsQR = require('jsqr');
+  const kernel = binarize.create();
+  const img = litSymbol(), n = img.width * img.height, mp = n / 1e6;
+  const time = (fn) => { const t0 = process.hrtime.bigint(); let out; for (let i = 0; i < BENCH_N; i++) out = fn(); return [Number(process.hrtime.bigint() - t0) / 1e6 / BENCH_N, out]; };
+  const toRGBA = (bin) => {
+    const out = new Uint8ClampedArray(n * 4);
+    for (let i = 0, j = 0; i < n; i++, j += 4) { out[j] = out[j + 1] = out[j + 2] = bin[i]; out[j + 3] = 255; }
+    return out;
+  };
+  console.log(`binarize: ${img.width}x${img.height}, ${BENCH_N} runs each, SIMD=${kernel.simd}`);
+
+  const [lumaJs, gray] = time(() => binarize.lumaJs(img.data, n));
+  const [lumaSimd] = time(() => kernel.luma(img.data, n));
+  const [thrJs, ref] = time(() => binarize.thresholdJs(gray, img.width, img.height));
+  const [thrSimd, bin] = time(() => kernel.threshold(gray, img.width, img.height));
+  const same = ref.every((v, i) => v === bin[i]);
+  const [raw, hitRaw] = time(() => jsQR(img.data, img.width, img.height));
+  const [pre, hitPre] = time(() => jsQR(toRGBA(kernel.threshold(kernel.luma(img.data, n), img.width, img.height)), img.width, img.height, { inversionAttempts: 'dontInvert' }));
+
+  const row = (name, ms, note = '') => console.log(`${name.padEnd(34)} ${ms.toFixed(2).padStart(9)} ms  ${(mp / (ms / 1000)).toFixed(1).padStart(7)} MP/s  ${note}`);
+  row('luma (scalar JS)', lumaJs);
+  row('luma (WASM SIMD)', lumaSimd, `${(lumaJs / lumaSimd).toFixed(1)}x`);
+  row('threshold (scalar JS)', thrJs);
+  row('threshold (WASM SIMD)', thrSimd, `${(thrJs / thrSimd).toFixed(1)}x, ${same ? 'identical' : 'MISMATCH'}`);
+  row('jsQR, raw image', raw, hitRaw ? 'decoded' : 'not decoded');
+  row('jsQR, SIMD-binarized, dontInvert', pre, hitPre ? 'decoded' : 'not decoded');
+}
+
+async function benchHash() {
+  const blake3 = require('../shared/blake3');
+  const hashing = require('./hash');
+  const size = Math.max(1, parseInt(process.env.BENCH_MB || '64', 10)) * 1048576;
+  const src = Buffer.from(new SharedArrayBuffer(size));
+  crypto.randomFillSync(src);
+  const simd = blake3.create(), real = global.WebAssembly;
+  global.WebAssembly = undefined;
+  const scalar = blake3.create();
+  global.WebAssembly = real;
+  const time = async (fn) => { const t0 = Date.now(); const out = await fn(); return [Date.now() - t0, out]; };
+  console.log(`hash: ${size / 1048576} MiB, SIMD=${simd.simd}`);
+
+  const row = (name, ms, note = '') => console.log(`${name.padEnd(34)} ${String(ms).padStart(7)} ms  ${mbps(size, ms).padStart(9)} MB/s  ${note}`);
+  const [sha] = await time(() => crypto.createHash('sha256').update(src).digest('hex'));
+  row('sha256 (one core)', sha);
+  const [js, ref] = await time(() => blake3.toHex(scalar.hash(src.subarray(0, Math.min(size, 8 << 20)))));
+  row('blake3 scalar JS (8 MiB)', js * size / Math.min(size, 8 << 20));
+  const [one, want] = await time(() => blake3.toHex(simd.hash(src)));
+  row('blake3 WASM SIMD (one core)', one, size <= 8 << 20 ? (ref === want ? 'identical' : 'MISMATCH') : '');
+  const [tree, got] = await time(() => hashing.hashAll('blake3', src, size));
+  row('blake3 tree (hash workers)', tree, got.whole === want ? 'identical' : 'MISMATCH');
+}
+
+const SUITES = { symbology: benchSymbology, binarize: benchBinarize, hash: benchHash };
+
+async function main(argv = process.argv.slice(2)) {
+  const names = argv.length ? argv : Object.keys(SUITES);
+  for (const name of names) {
+    if (!SUITES[name]) { console.error(`Unknown suite ${name} (available: ${Object.keys(SUITES).join(', ')})`); process.exit(1); }
+    await SUITES[name]();
+  }
+}
+
+if (require.main === module) main().catch((e) => { console.error(e.message || e); process.exit(1); });
+module.exports = { main, SUITES };
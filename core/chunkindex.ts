@@ -0,0 +1,156 @@
+/**
+ * GitZipQR — Sidecar chunk index
+ * QR_INDEX=1 makes the encoder write `gitzipqr.index` next to the images. Its
+ * first line is a JSON header:
+ *   { type, version, fileId, name, ext, total, hashAlg, [shard, from, to,] images }
+ * followed by one tab-separated line per symbol:
+ *   file  imageSha256  chunk  part  partTotal  chunkHash
+ * file is relative to the index, '/'-separated when the images are sharded (core/layout.ts).
+ * An RGB image has one line for each of its channels. chunkHash is set on part 0
+ * only (later parts have "-"), like the frame metadata.
+ *
+ * `encode --shard i/n` writes `gitzipqr.<i>-of-<n>.index` instead, covering its
+ * chunks [from, to) only. Once the shards' trees are merged, read() loads all n
+ * of them as one index; it refuses an incomplete or mixed set, since a partial
+ * index would make the decoder stop before it has every chunk.
+ *
+ * The decoder checks the directory listing against the index before it looks
+ * at any pixels. Missing symbols fail at once. An image listed twice with the
+ * same hash is decoded once. Each image's bytes are checked against its hash in
+ * the worker before decoding. `decode <dir> --check` reports completeness from
+ * the listing alone, and `--check --verify` also hashes every image.
+ */
+const fs = require('fs');
+const path = require('path');
+const crypto = require('crypto');
+const layout = require('./layout');
+const sharding = require('./shard');
+
+const INDEX_NAME = 'gitzipqr.index';
+const INDEX_TYPE = 'GitZipQR-INDEX';
+const VERSION = 1;
+const SHARD_INDEX = /^gitzipqr\.(\d+)-of-(\d+)\.index$/;
+
+/** File name of the index an encode (or one shard of it) writes. */
+function indexName(shard) {
+  return shard ? `gitzipqr.${shard.i}-of-${shard.n}.index` : INDEX_NAME;
+}
+
+/** Whether a file name (or '/'-separated relative path) is an index, whole or per shard. */
+function isIndex(rel) {
+  const name = path.posix.basename(rel);
+  return name === INDEX_NAME || SHARD_INDEX.test(name);
+}
+
+/**
+ * entries: [{ file, sha256, chunk, part, partTotal, hash }]; file is relative to dir.
+ * A header with `shard` ({ i, n }) goes to that shard's own file.
+ */
+function write(dir, header, entries) {
+  const lines = [JSON.stringify({ type: INDEX_TYPE, version: VERSION, ...header, images: 'sha256' })];
+  for (const e of entries) lines.push([e.file, e.sha256, e.chunk, e.part, e.partTotal, e.part === 0 ? e.hash : '-'].join('\t'));
+  const p = path.join(dir, indexName(header.shard));
+  fs.writeFileSync(p, lines.join('\n') + '\n');
+  return p;
+}
+
+function readFile(p) {
+  const [head, ...rows] = fs.readFileSync(p, 'utf8').split('\n');
+  const header = JSON.parse(head);
+  if (header.type !== INDEX_TYPE) throw new Error(`${p} is not a GitZipQR index`);
+  if (header.version !== VERSION) throw new Error(`Unsupported index version ${header.version}`);
+  const entries = [];
+  for (const row of rows) {
+    if (!row) continue;
+    const [file, sha256, chunk, part, partTotal, hash] = row.split('\t');
+    entries.push({ file, sha256, chunk: +chunk, part: +part, partTotal: +partTotal, hash: hash === '-' ? null : hash });
+  }
+  return { header, entries };
+}
+
+/**
+ * { header, entries } from dir/gitzipqr.index, else merged from the per-shard
+ * indexes in dir; null when there are none.
+ */
+function read(dir) {
+  const p = path.join(dir, INDEX_NAME);
+  if (fs.existsSync(p)) return readFile(p);
+  const files = fs.readdirSync(dir).filter(f => SHARD_INDEX.test(f)).sort();
+  if (!files.length) return null;
+  const parts = files.map(f => readFile(path.join(dir, f)));
+  const { shard: _s, from: _f, to: _t, ...header } = parts[0].header;
+  const { fileId, total } = header, n = parts[0].header.shard.n;
+  const seen = new Set();
+  for (const { header: h } of parts) {
+    if (h.fileId !== fileId || h.shard.n !== n) throw new Error(`Shard indexes in ${dir} belong to different encodes (${fileId} ${n} shards, ${h.fileId} ${h.shard.n} shards)`);
+    const [from, to] = sharding.range(total, h.shard);
+    if (h.from !== from || h.to !== to) throw new Error(`Shard index ${h.shard.i}/${n} covers chunks ${h.from}..${h.to - 1}, expected ${from}..${to - 1}`);
+    seen.add(h.shard.i);
+  }
+  const absent = Array.from({ length: n }, (_, i) => i).filter(i => !seen.has(i));
+  if (absent.length) throw new Error(`Incomplete index in ${dir}: no gitzipqr.<i>-of-${n}.index for shard(s) ${absent.join(', ')}`);
+  return { header, entries: parts.flatMap(x => x.entries) };
+}
+
+/**
+ * Matches the index against the files present in dir (names relative to dir):
+ *   images     indexed files to decode, one per distinct image hash
+ *   hashes     Map(absolute path -> expected sha256)
+ *   missing    [{ chunk, part, partTotal, files }] symbols with no image on disk
+ *   duplicates indexed files skipped because an identical image is planned
+ *   extra      files on disk the index does not list
+ */
+function plan(dir, index, names) {
+  const present = new Set(names), listed = new Set(), seen = new Map(), hashes = new Map();
+  const images = [], duplicates = [], covered = new Set(), symbols = new Map();
+  for (const e of index.entries) {
+    const key = `${e.chunk}:${e.part}`;
+    if (!symbols.has(key)) symbols.set(key, { chunk: e.chunk, part: e.part, partTotal: e.partTotal, files: [] });
+    symbols.get(key).files.push(e.file);
+    listed.add(e.file);
+    if (!present.has(e.file)) continue;
+    covered.add(key);
+    const abs = path.join(dir, e.file);
+    if (hashes.has(abs)) continue; // further channels of an RGB image
+    hashes.set(abs, e.sha256);
+    if (seen.has(e.sha256)) { duplicates.push(e.file); continue; }
+    seen.set(e.sha256, abs);
+    images.push(abs);
+  }
+  const missing = [...symbols.entries()].filter(([key]) => !covered.has(key)).map(([, s]) => s);
+  // Symbols the index should have but does not (e.g. a truncated index file).
+  for (let c = 0; c < (index.header.total || 0); c++) {
+    if (!symbols.has(`${c}:0`)) missing.push({ chunk: c, part: 0, partTotal: 1, files: [] });
+  }
+  missing.sort((a, b) => a.chunk - b.chunk || a.part - b.part);
+  const extra = names.filter(n => !listed.has(n));
+  return { images, hashes, missing, duplicates, extra, symbols: symbols.size };
+}
+
+function sha256File(p) {
+  return crypto.createHash('sha256').update(fs.readFileSync(p)).digest('hex');
+}
+
+function describeMissing(missing, max = 10) {
+  const list = missing.slice(0, max).map(s => `chunk ${s.chunk}${s.partTotal > 1 ? ` part ${s.part + 1}/${s.partTotal}` : ''}${s.files.length ? ` (${s.files.join(', ')})` : ''}`);
+  return list.join('; ') + (missing.length > max ? `; ... ${missing.length - max} more` : '');
+}
+
+/**
+ * Completeness of an image directory from its index and listing; verify also
+ * hashes every planned image. Returns { ok, header, symbols, images, missing, duplicates, extra, corrupt }.
+ */
+async function check(dir, { verify = false } = {}) {
+  const index = read(dir);
+  if (!index) throw new Error(`No ${INDEX_NAME} in ${dir} (encode with QR_INDEX=1)`);
+  const names = await layout.list(dir, isIndex);
+  const p = plan(dir, index, names);
+  const corrupt = verify ? p.images.filter(abs => sha256File(abs) !== p.hashes.get(abs)).map(abs => layout.relative(dir, abs)) : [];
+  return {
+    ok: !p.missing.length && !corrupt.length,
+    header: index.header, symbols: p.symbols, images: p.images.length,
+    missing: p.missing, duplicates: p.duplicates, extra: p.extra, corrupt,
+  };
+}
+
+module.exports = { INDEX_NAME, indexName, isIndex, write, read, plan, check, describeMissing };
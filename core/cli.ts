@@ -0,0 +1,38 @@
+/**
+ * GitZipQR — CLI entry
+ * Single entry point for the compiled `gitrip` binary (bun run build:cli).
+ * Commands are required lazily so e.g. `gitrip help` never loads archiver or the QR libraries.
+ */
+const COMMANDS = {
+  encode: () => require('./encode').main,
+  decode: () => require('./decode').main,
+  sync: () => (argv) => {
+    const [src, dest] = argv;
+    if (!src || !dest) { console.error('Usage: gitrip sync <src_folder> <dest_folder>'); process.exit(1); }
+    return require('./sync').sync(src, dest);
+  },
+  daemon: () => require('./daemon').main,
+};
+
+function usage() {
+  console.log('GitZipQR CLI');
+  console.log('Usage:');
+  console.log('  gitrip encode <input_file_or_dir> [output_dir] [--shard i/n]');
+  console.log('  gitrip decode <qrcodes_dir> [output_dir]');
+  console.log('  gitrip decode <qrcodes_dir> --check [--verify]');
+  console.log('  gitrip decode <qrcodes_dir> <parts_dir> --shard i/n');
+  console.log('  gitrip decode <parts_dir> [output_dir] --merge');
+  console.log('  gitrip sync <src_folder> <dest_folder>');
+  console.log('  gitrip daemon [--port N | --socket /path/to.sock]');
+}
+
+async function main(argv = process.argv.slice(2)) {
+  const [cmd, ...rest] = argv;
+  if (cmd === '--version' || cmd === '-v') { console.log(require('../package.json').version); return; }
+  const load = COMMANDS[cmd];
+  if (!load) { usage(); if (cmd && cmd !== 'help' && cmd !== '--help' && cmd !== '-h') process.exit(1); return; }
+  await load()(rest);
+}
+
+if (require.main === module) main();
+module.exports = { main };
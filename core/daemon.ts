@@ -0,0 +1,231 @@
+/**
+ * GitZipQR — Daemon
+ * Resident encode/decode service with warm worker pools and a priority job queue.
+ * Jobs read and write any path the daemon user can, so access is restricted:
+ * by default it listens on a Unix socket that only its owner can open
+ * ($GITZIPQR_SOCKET, or gitzipqr.sock in $XDG_RUNTIME_DIR or a private 0700
+ * directory under the temp dir). TCP on 127.0.0.1 (--port) needs
+ * GITZIPQR_TOKEN, sent as "Authorization: Bearer <token>". When the token is
+ * set, it is checked on the socket too.
+ *
+ *   POST   /jobs      {"op":"encode"|"decode","input":"...","output":"...","passwords":["..."],"priority":0}
+ *   GET    /jobs      list jobs (newest first)
+ *   GET    /jobs/:id  job status / result
+ *   DELETE /jobs/:id  cancel a queued job
+ *   GET    /status    queue and pool summary
+ *
+ * Usage: bun run daemon [--socket /path/to.sock | --port N]
+ */
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const http = require('http');
+const crypto = require('crypto');
+const { encode, createEncodePool } = require('./encode');
+const { decode, createDecodePool } = require('./decode');
+
+const resources = require('./resources');
+
+// Both pools share the container's CPU quota and memory limit (core/resources.ts).
+const PLAN = resources.plan('daemon');
+const MAX_WORKERS = PLAN.workers;
+const MAX_JOBS = Math.max(1, parseInt(process.env.DAEMON_JOBS || '1', 10));        // jobs running at once
+const HISTORY = Math.max(1, parseInt(process.env.DAEMON_HISTORY || '1000', 10));   // finished jobs kept
+const MAX_BODY = 1 << 20;
+const TOKEN = process.env.GITZIPQR_TOKEN || '';
+const MIN_TOKEN = 16;
+
+const pools = { encode: createEncodePool(MAX_WORKERS), decode: createDecodePool(MAX_WORKERS) };
+const jobs = new Map();      // id -> job (public view)
+const secrets = new Map();   // id -> passwords, dropped as soon as the job starts
+const queue = [];            // queued jobs, highest priority first, FIFO within a priority
+let running = 0;
+
+function publicJob(j) { return { ...j }; }
+
+function enqueue(job) {
+  let i = queue.length;
+  while (i > 0 && queue[i - 1].priority < job.priority) i--;
+  queue.splice(i, 0, job);
+}
+
+function prune() {
+  if (jobs.size <= HISTORY) return;
+  for (const [id, j] of jobs) {
+    if (jobs.size <= HISTORY) break;
+    if (j.state === 'done' || j.state === 'failed' || j.state === 'cancelled') jobs.delete(id);
+  }
+}
+
+async function execute(job, passwords) {
+  if (job.op === 'encode') {
+    const r = await encode(job.input, job.output, passwords, { pool: pools.encode });
+    return { qrDir: r.qrDir, fileId: r.fileId, totalChunks: r.totalChunks };
+  }
+  return { outPath: await decode(job.input, job.output, passwords, { pool: pools.decode }) };
+}
+
+function schedule() {
+  while (running < MAX_JOBS && queue.length) {
+    const job = queue.shift();
+    const passwords = secrets.get(job.id); secrets.delete(job.id);
+    running++;
+    job.state = 'running'; job.startedAt = new Date().toISOString();
+    execute(job, passwords)
+      .then((result) => { job.state = 'done'; job.result = result; })
+      .catch((e) => { job.state = 'failed'; job.error = String(e && e.message || e); })
+      .finally(() => {
+        job.finishedAt = new Date().toISOString();
+        running--; prune(); schedule();
+      });
+  }
+}
+
+function submit(body) {
+  const op = body && body.op;
+  if (op !== 'encode' && op !== 'decode') throw new Error('op must be "encode" or "decode"');
+  if (!body.input || typeof body.input !== 'string') throw new Error('input path is required');
+  if (!Array.isArray(body.passwords) || !body.passwords.length || body.passwords.some(p => typeof p !== 'string' || p.length < 8)) {
+    throw new Error('passwords must be a non-empty array of strings (min 8 characters each)');
+  }
+  const job = {
+    id: crypto.randomBytes(8).toString('hex'),
+    op,
+    input: body.input,
+    output: typeof body.output === 'string' && body.output ? body.output : process.cwd(),
+    priority: Number.isFinite(body.priority) ? body.priority : 0,
+    state: 'queued',
+    createdAt: new Date().toISOString(),
+    startedAt: null, finishedAt: null, result: null, error: null
+  };
+  jobs.set(job.id, job); secrets.set(job.id, body.passwords);
+  enqueue(job); schedule();
+  return job;
+}
+
+function cancel(id) {
+  const i = queue.findIndex(j => j.id === id);
+  if (i < 0) return false;
+  const [job] = queue.splice(i, 1);
+  secrets.delete(id);
+  job.state = 'cancelled'; job.finishedAt = new Date().toISOString();
+  return true;
+}
+
+function status() {
+  return {
+    pid: process.pid,
+    uptime: Math.round(process.uptime()),
+    workers: MAX_WORKERS,
+    resources: resources.describe(PLAN),
+    maxJobs: MAX_JOBS,
+    queued: queue.length,
+    running,
+    jobs: jobs.size,
+    pools: {
+      encode: { live: pools.encode.workers.length, active: pools.encode.active, limit: pools.encode.limit },
+      decode: { live: pools.decode.workers.length, active: pools.decode.active, limit: pools.decode.limit }
+    }
+  };
+}
+
+/* ---- HTTP ---- */
+function send(res, code, obj) {
+  const body = JSON.stringify(obj);
+  res.writeHead(code, { 'content-type': 'application/json', 'content-length': Buffer.byteLength(body) });
+  res.end(body);
+}
+function readBody(req) {
+  return new Promise((resolve, reject) => {
+    let size = 0; const parts = [];
+    req.on('data', (d) => { size += d.length; if (size > MAX_BODY) { reject(new Error('request body too large')); req.destroy(); } else parts.push(d); });
+    req.on('end', () => {
+      try { resolve(parts.length ? JSON.parse(Buffer.concat(parts).toString('utf8')) : {}); }
+      catch { reject(new Error('request body is not valid JSON')); }
+    });
+    req.on('error', reject);
+  });
+}
+
+function authorized(req) {
+  if (!TOKEN) return true;
+  const given = Buffer.from(String(req.headers.authorization || ''));
+  const want = Buffer.from(`Bearer ${TOKEN}`);
+  return given.length === want.length && crypto.timingSafeEqual(given, want);
+}
+
+async function handle(req, res) {
+  const url = new URL(req.url, 'http://localhost');
+  const m = url.pathname.match(/^\/jobs\/([0-9a-f]+)$/);
+  if (!authorized(req)) return send(res, 401, { error: 'missing or wrong bearer token' });
+  try {
+    if (req.method === 'GET' && url.pathname === '/status') return send(res, 200, status());
+    if (req.method === 'GET' && url.pathname === '/jobs') return send(res, 200, [...jobs.values()].reverse().map(publicJob));
+    if (req.method === 'POST' && url.pathname === '/jobs') return send(res, 202, publicJob(submit(await readBody(req))));
+    if (m && req.method === 'GET') {
+      const job = jobs.get(m[1]);
+      return job ? send(res, 200, publicJob(job)) : send(res, 404, { error: 'job not found' });
+    }
+    if (m && req.method === 'DELETE') {
+      if (!jobs.has(m[1])) return send(res, 404, { error: 'job not found' });
+      return cancel(m[1]) ? send(res, 200, publicJob(jobs.get(m[1]))) : send(res, 409, { error: 'job is not queued' });
+    }
+    send(res, 404, { error: 'not found' });
+  } catch (e) {
+    send(res, 400, { error: String(e && e.message || e) });
+  }
+}
+
+/** Default socket path: in $XDG_RUNTIME_DIR, else in a private per-user directory under the temp dir. */
+function defaultSocket() {
+  if (process.env.XDG_RUNTIME_DIR) return path.join(process.env.XDG_RUNTIME_DIR, 'gitzipqr.sock');
+  const uid = typeof process.getuid === 'function' ? process.getuid() : os.userInfo().username;
+  const dir = path.join(os.tmpdir(), `gitzipqr-${uid}`);
+  fs.mkdirSync(dir, { recursive: true, mode: 0o700 });
+  const st = fs.lstatSync(dir);
+  if (!st.isDirectory() || (typeof process.getuid === 'function' && st.uid !== process.getuid()) || (st.mode & 0o077)) {
+    throw new Error(`${dir} must be a directory owned by this user with mode 0700`);
+  }
+  return path.join(dir, 'daemon.sock');
+}
+
+function listen(opts) {
+  opts = opts || {};
+  const port = opts.port || (!opts.socket && process.env.GITZIPQR_PORT);
+  if (port && TOKEN.length < MIN_TOKEN) {
+    throw new Error(`TCP mode needs GITZIPQR_TOKEN (at least ${MIN_TOKEN} characters); or use the default Unix socket`);
+  }
+  const server = http.createServer((req, res) => { handle(req, res); });
+  const socket = port ? null : opts.socket || process.env.GITZIPQR_SOCKET || defaultSocket();
+  const shutdown = async () => {
+    server.close();
+    await Promise.all([pools.encode.destroy(), pools.decode.destroy()]);
+    if (socket && fs.existsSync(socket)) fs.unlinkSync(socket);
+    process.exit(0);
+  };
+  process.once('SIGINT', shutdown); process.once('SIGTERM', shutdown);
+  if (socket) {
+    if (fs.existsSync(socket)) fs.unlinkSync(socket);
+    // The socket is created 0600 under the umask, never briefly open to other users.
+    const umask = process.umask(0o177);
+    server.once('listening', () => process.umask(umask));
+    server.once('error', () => process.umask(umask));
+    server.listen(socket, () => console.log(`GitZipQR daemon listening on ${socket}`));
+  } else {
+    server.listen(parseInt(port, 10), '127.0.0.1', () => console.log(`GitZipQR daemon listening on http://127.0.0.1:${port} (bearer token)`));
+  }
+  return server;
+}
+
+async function main(argv = process.argv.slice(2)) {
+  const opts = { socket: undefined, port: undefined };
+  for (let i = 0; i < argv.length; i++) {
+    if (argv[i] === '--socket') opts.socket = argv[++i];
+    else if (argv[i] === '--port') opts.port = argv[++i];
+    else { console.error('Usage: bun run daemon [--socket /path/to.sock | --port N]'); process.exit(1); }
+  }
+  try { listen(opts); } catch (e) { console.error(e.message || e); process.exit(1); }
+}
+
+if (require.main === module) main();
+module.exports = { listen, submit, status, main };
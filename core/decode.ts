@@ -5,10 +5,17 @@
  */
 const fs = require('fs');
 const path = require('path');
-const os = require('os');
 const crypto = require('crypto');
-const { Worker } = require('worker_threads');
 const readline = require('readline');
+const { WorkerPool, workerPath } = require('./pool');
+const { FRAGMENT_TYPE, KCV_LABEL } = require('../shared/frame');
+const { Decoder: FountainDecoder } = require('../shared/fountain');
+const { isAnimatedPng, readApngFrames } = require('./apng');
+const resources = require('./resources');
+const hashing = require('./hash');
+const chunkIndex = require('./chunkindex');
+const layout = require('./layout');
+const sharding = require('./shard');
 
 function scryptAsync(password, salt, keylen, opts) {
   return new Promise((resolve, reject) => {
@@ -18,8 +25,9 @@ function scryptAsync(password, salt, keylen, opts) {
   });
 }
 
-const FRAGMENT_TYPE = "GitZipQR-CHUNK-ENC";
-const MAX_WORKERS = Math.max(1, parseInt(process.env.QR_WORKERS || String(os.cpus().length), 10));
+// Pool size from CPU quota and memory limit (core/resources.ts); QR_WORKERS pins it.
+const PLAN = resources.plan('decode');
+const MAX_WORKERS = PLAN.workers;
 
 function stepStart(n, label) { process.stdout.write(`STEP #${n} ${label} ... `); }
 function stepDone(ok) { process.stdout.write(`[${ok ? 1 : 0}]\n`); }
@@ -70,28 +78,64 @@ function listFragmentsFlexible(p) {
   return res;
 }
 
-function runDecodePool(images) {
-  let i = 0, active = 0; const results = new Array(images.length);
-  return new Promise((resolve) => {
-    function launch() {
-      while (active < MAX_WORKERS && i < images.length) {
-        const idx = i++; const img = images[idx]; active++;
-        const w = new Worker(path.join(__dirname, 'qrdecode.worker.ts'), { workerData: { img } });
-        w.once('message', (msg) => {
-          active--; results[idx] = msg;
-          if ((idx + 1) % 100 === 0 || idx + 1 === images.length) process.stdout.write(`QR read ${idx + 1}/${images.length}\r`);
-          if (i < images.length) launch(); else if (active === 0) { process.stdout.write('\n'); resolve(results); }
-        });
-        w.once('error', () => { active--; results[idx] = { ok: false, error: 'worker error' }; if (i < images.length) launch(); else if (active === 0) resolve(results); });
+function createDecodePool(size = MAX_WORKERS) { return resources.govern(new WorkerPool(workerPath('qrdecode.worker.ts'), size)); }
+/**
+ * Feeds images (paths, or PNG bytes that are transferred; an array or an async
+ * iterable such as layout.walk()) to the pool with at most 2x pool size in flight, handing each reply to onResult(reply, image) as
+ * it lands. hashes (path -> sha256, from the chunk index) go along with the task.
+ * Once abort.error or abort.done is set no new images are queued, so a failed
+ * key check or a completed fountain stops the scan within a few images
+ * (without touching other jobs on a shared daemon pool).
+ */
+async function runDecodePool(images, pool, onResult = () => {}, abort = {}, hashes = null) {
+  let done = 0, next = 0; const results = [];
+  const it = Array.isArray(images) ? images[Symbol.iterator]() : images[Symbol.asyncIterator]();
+  const total = Array.isArray(images) ? `/${images.length}` : '';
+  async function lane() {
+    while (!abort.error && !abort.done) {
+      const { value: img, done: end } = await it.next();
+      if (end) break;
+      const idx = next++;
+      const sha256 = hashes && typeof img === 'string' ? hashes.get(img) : undefined;
+      const msg = await pool.run(sha256 ? { img, sha256 } : { img }, typeof img === 'string' ? undefined : [img.buffer]);
+      results[idx] = msg; done++;
+      onResult(msg, img);
+      if (done % 100 === 0) process.stdout.write(`QR read ${done}${total}\r`);
+    }
+  }
+  await Promise.all(Array.from({ length: pool.size * 2 }, lane));
+  if (done) process.stdout.write(`QR read ${done}${total}\n`);
+  if (abort.error) throw abort.error;
+  return results;
+}
+
+/* Key derivation runs on the libuv threadpool while the images are still being read. */
+function deriveKey(pass, salt, kdf, kcv) {
+  return Promise.resolve().then(() => scryptAsync(pass, salt, 32, resources.scryptOptions(kdf)))
+    .catch((e) => { throw new Error('KDF failed: ' + (e.message || e)); })
+    .then((key) => {
+      if (kcv && crypto.createHmac('sha256', key).update(KCV_LABEL).digest('hex').slice(0, 16) !== kcv) {
+        throw new Error('Wrong password (key check value mismatch).');
       }
-    } launch();
-  });
+      return key;
+    });
 }
 
 /* ---------------- Main API ---------------- */
-async function decode(inputPath, outputDir = process.cwd(), passwords) {
+/**
+ * opts.pool — a WorkerPool from createDecodePool() to reuse across calls.
+ * opts.shard — { i, n }: read only this shard's images and write their symbols
+ *   to a part file (no password); returns its path (core/shard.ts).
+ * opts.merge — input is a directory (or file) of part files from every shard.
+ * Failures are thrown (never process.exit) so long-lived callers survive them.
+ */
+async function decode(inputPath, outputDir = process.cwd(), passwords, opts = {}) {
   if (!fs.existsSync(outputDir)) fs.mkdirSync(outputDir, { recursive: true });
   const input = path.resolve(inputPath);
+  const shard = opts.shard || null;
+
+  // Passphrase first, so the KDF can start with the first decoded chunk.
+  const pass = shard ? null : Array.isArray(passwords) && passwords.length ? passwords.join('\u0000') : await promptPasswords();
 
   // STEP 1: collect
   stepStart(1, 'collect data');
@@ -99,51 +143,165 @@ async function decode(inputPath, outputDir = process.cwd(), passwords) {
   let nameBase = null;   // without extension
   let metaExt = null;    // with extension (".zip", ".png", ...)
   let cipherSha256 = null, expectedTotal = null, kdf = null, salt = null, nonce = null;
+  let hashAlg = 'sha256';   // meta.hashAlg of 3.3 payloads
+  let archive = null;       // archive fields of the first full metadata, for part files
+  const chunkHashes = [];   // blake3: checked in STEP 2 together with the archive hash
+  let keyJob = null;
+  const abort = {};
+  const startKdf = (kcv) => {
+    if (keyJob || pass == null || !(kdf && salt)) return;
+    keyJob = deriveKey(pass, salt, kdf, kcv);
+    keyJob.catch((e) => { abort.error = e; });
+  };
 
-  if (fs.existsSync(input) && fs.statSync(input).isDirectory()) {
-    const imgs = fs.readdirSync(input)
-      .map(f => path.join(input, f))
-      .filter(f => fs.statSync(f).isFile());
-    if (imgs.length) {
-      const results = await runDecodePool(imgs);
-      const acc = new Map();
-      for (const r of results) {
-        if (!r || !r.ok) continue;
-        const m = r.payload;
-        if (!(m && m.type === FRAGMENT_TYPE && typeof m.chunk === 'number' && typeof m.total === 'number')) continue;
-        if (m.dataB64) {
-          const key = `${m.fileId}:${m.chunk}`;
-          if (!acc.has(key)) acc.set(key, { parts: [], total: m.partTotal || 1 });
-          const entry = acc.get(key);
-          entry.parts[(typeof m.part === 'number') ? m.part : 0] = m.dataB64;
-          entry.total = m.partTotal || 1;
-
-          if (!nameBase && m.name) nameBase = m.name;
-          if (!metaExt && m.ext != null) metaExt = String(m.ext);
-          if (!cipherSha256) cipherSha256 = m.cipherHash;
-          if (!kdf && m.kdfParams) kdf = m.kdfParams;
-          if (!salt && m.saltB64) salt = Buffer.from(m.saltB64, 'base64');
-          if (!nonce && m.nonceB64) nonce = Buffer.from(m.nonceB64, 'base64');
-          if (!expectedTotal) expectedTotal = m.total;
-        }
+  const isDir = fs.existsSync(input) && fs.statSync(input).isDirectory();
+  const animated = !isDir && !opts.merge && fs.existsSync(input) && isAnimatedPng(input);
+  if (shard && !isDir) { stepDone(0); throw new Error('--shard needs a directory of QR images'); }
+  // Index and part files at any depth are not images; a shard skips other shards' images.
+  const skip = (rel) => chunkIndex.isIndex(rel) || rel.endsWith(sharding.PART_EXT)
+    || (shard != null && !sharding.owns(rel, shard));
+  // With a chunk index the listing alone tells whether every symbol is there;
+  // indexed images go first, unlisted files only run if symbols are still missing.
+  let planned = null;
+  if (isDir && !opts.merge && opts.index !== false) {
+    let index;
+    try { index = chunkIndex.read(input); } catch (e) { stepDone(0); throw e; }
+    if (index) {
+      const names = await layout.list(input, chunkIndex.isIndex);
+      planned = chunkIndex.plan(input, index, names);
+      if (shard) planned.images = planned.images.filter(abs => sharding.owns(layout.relative(input, abs), shard));
+      if (planned.missing.length) {
+        stepDone(0);
+        throw new Error(`Missing ${planned.missing.length}/${planned.symbols} QR symbols (${chunkIndex.INDEX_NAME}): ${chunkIndex.describeMissing(planned.missing)}`);
+      }
+    }
+  }
+  if (isDir || animated || opts.merge) {
+    // Plain directories are streamed, nested ones (QR_SHARD_FANOUT) included.
+    const imgs = opts.merge ? null
+      : animated ? readApngFrames(fs.readFileSync(input))
+      : planned ? [...planned.images, ...planned.extra.filter(f => !skip(f)).map(f => path.join(input, f))]
+      : layout.walk(input, skip);
+    const acc = new Map();
+    let fountain = null, fountainLen = 0, filled = 0;
+    const corrupt = [];
+    const onItem = (r) => {
+      if (!r.data) return;
+      const m = r.meta;
+      if (!(m && m.type === FRAGMENT_TYPE)) return;
+      if (m.fountain) {
+        if (shard) { abort.error = new Error('--shard does not apply to fountain frames: a few percent over k of them restore the archive on one host'); return; }
+        // Droplet frame: about 1.01k distinct seeds, in any order, rebuild the ciphertext.
+        if (!fountain) { fountain = new FountainDecoder(m.fountain.k, r.data.length); fountainLen = m.fountain.len; }
+        if (fountain.add(m.fountain.seed, r.data)) abort.done = true;
+      } else {
+        // Linked parts after the first carry only { type, fileId, chunk, part, partTotal }.
+        if (!(typeof m.chunk === 'number' && (typeof m.total === 'number' || typeof m.part === 'number'))) return;
+        const key = `${m.fileId}:${m.chunk}`;
+        if (!acc.has(key)) acc.set(key, { parts: [], total: m.partTotal || 1, hash: null });
+        const entry = acc.get(key);
+        const part = (typeof m.part === 'number') ? m.part : 0;
+        if (!entry.parts[part]) filled++;
+        entry.parts[part] = Buffer.from(r.data.buffer, r.data.byteOffset, r.data.byteLength);
+        if (planned && !shard && filled >= planned.symbols) abort.done = true;
+        entry.total = m.partTotal || 1;
+        if (m.hash) entry.hash = m.hash;
+        if (!expectedTotal && m.total) expectedTotal = m.total;
       }
-      if (acc.size > 0) {
+
+      if (!archive && m.name != null && m.cipherHash) {
+        const { chunk, total, hash, part, partTotal, chunkSize, dataB64, ...rest } = m;
+        archive = rest;
+      }
+      if (!nameBase && m.name) nameBase = m.name;
+      if (!metaExt && m.ext != null) metaExt = String(m.ext);
+      if (!cipherSha256) cipherSha256 = m.cipherHash;
+      if (m.hashAlg) hashAlg = m.hashAlg;
+      if (!kdf && m.kdfParams) kdf = m.kdfParams;
+      if (!salt && m.saltB64) salt = Buffer.from(m.saltB64, 'base64');
+      if (!nonce && m.nonceB64) nonce = Buffer.from(m.nonceB64, 'base64');
+      startKdf(m.kcv);
+    };
+    // Color images answer with up to three symbols in `items`.
+    const onResult = (r, img) => {
+      if (r && r.ok) for (const item of r.items || [r]) onItem(item);
+      else if (r && r.corrupt) corrupt.push(layout.relative(input, img));
+    };
+    let results;
+    if (opts.merge) {
+      // Part files replay their symbols through the same checks as decoded images.
+      try {
+        results = [];
+        const parts = sharding.readParts(input);
+        const meta = (parts.find(p => p.header.meta) || { header: {} }).header.meta || {};
+        for (const { header, records } of parts) {
+          for (const rec of records) {
+            onItem({ meta: { ...meta, type: FRAGMENT_TYPE, fileId: header.fileId, total: header.total, chunk: rec.chunk, part: rec.part, partTotal: rec.partTotal, hash: rec.hash }, data: rec.data });
+            results.push(rec);
+          }
+        }
+      } catch (e) { stepDone(0); throw e; }
+    } else {
+      const pool = opts.pool || createDecodePool();
+      try { results = await runDecodePool(imgs, pool, onResult, abort, planned && planned.hashes); }
+      catch (e) { stepDone(0); throw e; }
+      finally { if (!opts.pool) await pool.destroy(); }
+    }
+    if (!results.length && !shard) { stepDone(0); throw new Error(opts.merge ? "Part files hold no symbols." : "Directory has no QR images."); }
+    if (shard) {
+      // A shard that owns no chunk images still writes its (empty) part, so --merge can complete.
+      let file, records = [], verified = 0;
+      try {
+        const fileId = archive ? archive.fileId : acc.size ? acc.keys().next().value.split(':')[0] : null;
         for (const [key, entry] of acc.entries()) {
-          for (let p = 0; p < (entry.total || 1); p++) {
-            if (typeof entry.parts[p] !== 'string') { stepDone(0); console.error(`Missing QR part ${p + 1}/${entry.total} for ${key}`); process.exit(1); }
+          const [id, chunk] = key.split(':');
+          if (id !== fileId) continue;
+          // Chunks held completely are checked here; the rest is checked after the merge.
+          let complete = true;
+          for (let p = 0; p < entry.total; p++) if (!entry.parts[p]) complete = false;
+          if (complete && entry.hash) {
+            if (hashing.digest(hashAlg, entry.total > 1 ? Buffer.concat(entry.parts) : entry.parts[0]) !== entry.hash) throw new Error(`Chunk hash mismatch: ${key}`);
+            verified++;
           }
-          const joinedB64 = (entry.total && entry.total > 1) ? entry.parts.join('') : entry.parts[0];
-          const buf = Buffer.from(joinedB64, 'base64');
-          const chunkIndex = parseInt(key.split(':')[1], 10);
-          chunks[chunkIndex] = buf;
+          entry.parts.forEach((data, part) => {
+            if (data) records.push({ chunk: +chunk, part, partTotal: entry.total, hash: part === 0 ? entry.hash : null, data });
+          });
+        }
+        file = sharding.writePart(outputDir, { fileId, shard, total: expectedTotal, meta: archive, verified }, records);
+      } catch (e) { stepDone(0); throw e; }
+      stepDone(1);
+      console.log(`\n✅ Shard ${shard.i}/${shard.n}: ${records.length} symbols, ${verified} verified chunks → ${file}`);
+      if (corrupt.length) console.log(`Image hash mismatch: ${corrupt.slice(0, 10).join(', ')}`);
+      return file;
+    }
+    if (fountain) {
+      if (!fountain.finish()) { stepDone(0); throw new Error(`Not enough fountain frames: ${fountain.solved}/${fountain.k} blocks recovered from ${fountain.seen.size} distinct frames`); }
+      chunks = [Buffer.from(fountain.result(fountainLen))];
+      expectedTotal = 1;
+      stepDone(1);
+    } else if (acc.size > 0) {
+      if (planned && !shard && filled < planned.symbols) {
+        stepDone(0);
+        throw new Error(`Read ${filled}/${planned.symbols} QR symbols${corrupt.length ? `; image hash mismatch: ${corrupt.slice(0, 10).join(', ')}` : ''}`);
+      }
+      for (const [key, entry] of acc.entries()) {
+        for (let p = 0; p < (entry.total || 1); p++) {
+          if (!entry.parts[p]) { stepDone(0); throw new Error(`Missing QR part ${p + 1}/${entry.total} for ${key}`); }
+        }
+        const buf = (entry.total && entry.total > 1) ? Buffer.concat(entry.parts) : entry.parts[0];
+        const chunkNo = parseInt(key.split(':')[1], 10);
+        if (hashAlg !== 'sha256') chunkHashes[chunkNo] = entry.hash;
+        else if (entry.hash && crypto.createHash('sha256').update(buf).digest('hex') !== entry.hash) {
+          stepDone(0); throw new Error(`Chunk hash mismatch: ${key}`);
         }
-        stepDone(1);
-      } else { stepDone(0); console.error("No inline QR data detected in images."); process.exit(1); }
-    } else { stepDone(0); console.error("Directory has no QR images."); process.exit(1); }
+        chunks[chunkNo] = buf;
+      }
+      stepDone(1);
+    } else { stepDone(0); throw new Error("No inline QR data detected in images."); }
   } else {
     // legacy
     const manifestPath = [path.join(path.dirname(input), 'manifest.json'), path.join(input, 'manifest.json'), path.join(process.cwd(), 'manifest.json')].find(p => fs.existsSync(p));
-    if (!manifestPath) { stepDone(0); console.error("No manifest.json for legacy fragments."); process.exit(1); }
+    if (!manifestPath) { stepDone(0); throw new Error("No manifest.json for legacy fragments."); }
     const manifest = JSON.parse(fs.readFileSync(manifestPath, 'utf8'));
     expectedTotal = manifest.totalChunks || manifest.total_chunks;
     cipherSha256 = manifest.cipherSha256 || manifest.cipher_sha256;
@@ -152,8 +310,9 @@ async function decode(inputPath, outputDir = process.cwd(), passwords) {
     nonce = Buffer.from(manifest.nonceB64 || manifest.nonce_b64, 'base64');
     nameBase = manifest.name || path.basename(input).replace(/\.[^./\\]+$/, '');
     metaExt = manifest.ext != null ? String(manifest.ext) : (manifest.archive_ext || '');
+    startKdf(manifest.kcv);
     let fragmentFiles = listFragmentsFlexible(input);
-    if (!fragmentFiles.length) { stepDone(0); console.error("No *.bin.json fragments found."); process.exit(1); }
+    if (!fragmentFiles.length) { stepDone(0); throw new Error("No *.bin.json fragments found."); }
     for (const fp of fragmentFiles) {
       const frag = JSON.parse(fs.readFileSync(fp, 'utf8'));
       if (frag.type !== FRAGMENT_TYPE) continue;
@@ -161,7 +320,7 @@ async function decode(inputPath, outputDir = process.cwd(), passwords) {
       if (!metaExt && frag.ext != null) metaExt = String(frag.ext);
       const buf = Buffer.from(frag.data, 'base64');
       const h = crypto.createHash('sha256').update(buf).digest('hex');
-      if (h !== frag.hash) { stepDone(0); console.error(`Chunk hash mismatch: ${path.basename(fp)}`); process.exit(1); }
+      if (h !== frag.hash) { stepDone(0); throw new Error(`Chunk hash mismatch: ${path.basename(fp)}`); }
       chunks[frag.chunk] = buf;
     }
     stepDone(1);
@@ -170,26 +329,44 @@ async function decode(inputPath, outputDir = process.cwd(), passwords) {
   // STEP 2: verify & assemble
   stepStart(2, 'verify & assemble');
   const present = chunks.filter(Boolean).length;
-  if (expectedTotal && present !== expectedTotal) { stepDone(0); console.error(`Missing chunks: ${present}/${expectedTotal}`); process.exit(1); }
-  const encBuffer = Buffer.concat(chunks);
-  if (cipherSha256) {
-    const globalCheck = crypto.createHash('sha256').update(encBuffer).digest('hex');
-    if (globalCheck !== cipherSha256) { stepDone(0); console.error(`Global sha256 mismatch. Expected ${cipherSha256}, got ${globalCheck}`); process.exit(1); }
+  if (expectedTotal && present !== expectedTotal) { stepDone(0); throw new Error(`Missing chunks: ${present}/${expectedTotal}`); }
+  let encBuffer;
+  if (hashAlg === 'sha256') {
+    encBuffer = Buffer.concat(chunks);
+    if (cipherSha256) {
+      const globalCheck = crypto.createHash('sha256').update(encBuffer).digest('hex');
+      if (globalCheck !== cipherSha256) { stepDone(0); throw new Error(`Global sha256 mismatch. Expected ${cipherSha256}, got ${globalCheck}`); }
+    }
+  } else {
+    // Assemble into shared memory so the hash workers check chunks and archive in one parallel pass.
+    const size = chunks.reduce((n, c) => n + (c ? c.length : 0), 0);
+    encBuffer = Buffer.from(new SharedArrayBuffer(size));
+    const ranges = [], expected = [];
+    let off = 0;
+    chunks.forEach((c, i) => {
+      if (!c) return;
+      encBuffer.set(c, off);
+      if (chunkHashes[i]) { ranges.push([off, c.length]); expected.push([i, chunkHashes[i]]); }
+      off += c.length;
+    });
+    let result;
+    try { hashing.check(hashAlg); result = await hashing.hashAll(hashAlg, encBuffer, cipherSha256 ? size : null, ranges); }
+    catch (e) { stepDone(0); throw e; }
+    const bad = expected.findIndex(([, h], k) => result.chunks[k] !== h);
+    if (bad >= 0) { stepDone(0); throw new Error(`Chunk hash mismatch: chunk ${expected[bad][0]}`); }
+    if (cipherSha256 && result.whole !== cipherSha256) {
+      stepDone(0); throw new Error(`Global ${hashAlg} mismatch. Expected ${cipherSha256}, got ${result.whole}`);
+    }
   }
   stepDone(1);
 
   // STEP 3: decrypt
   stepStart(3, 'decrypt');
-  if (!(nameBase != null && metaExt != null)) { stepDone(0); console.error("Meta name/ext missing. Re-encode with newer encoder."); process.exit(1); }
-  if (!(salt && nonce)) { stepDone(0); console.error("Crypto parameters are missing."); process.exit(1); }
-  const pass = Array.isArray(passwords) && passwords.length
-    ? passwords.join('\u0000')
-    : await (async () => { try { return (await promptPasswords()); } catch (e) { stepDone(0); throw e; } })();
-
+  if (!(nameBase != null && metaExt != null)) { stepDone(0); throw new Error("Meta name/ext missing. Re-encode with newer encoder."); }
+  if (!(salt && nonce && kdf)) { stepDone(0); throw new Error("Crypto parameters are missing."); }
+  startKdf();
   let key;
-  try {
-    key = await scryptAsync(pass, salt, 32, { N: kdf.N, r: kdf.r, p: kdf.p, maxmem: 512 * 1024 * 1024 });
-  } catch (e) { stepDone(0); console.error('KDF failed: ' + (e.message || e)); process.exit(1); }
+  try { key = await keyJob; } catch (e) { stepDone(0); throw e; }
   const tag = encBuffer.subarray(encBuffer.length - 16);
   const ciphertext = encBuffer.subarray(0, encBuffer.length - 16);
 
@@ -199,7 +376,7 @@ async function decode(inputPath, outputDir = process.cwd(), passwords) {
     decipher.setAuthTag(tag);
     dataBuf = Buffer.concat([decipher.update(ciphertext), decipher.final()]);
     stepDone(1);
-  } catch { stepDone(0); console.error("Decryption failed. Wrong password or corrupted data."); process.exit(1); }
+  } catch { stepDone(0); throw new Error("Decryption failed. Wrong password or corrupted data."); }
 
   // STEP 4: write as <name><ext> (ext may be empty — then no extension)
   stepStart(4, 'write output');
@@ -221,10 +398,36 @@ async function decode(inputPath, outputDir = process.cwd(), passwords) {
 
 }
 
-if (require.main === module) {
-  const inputArg = process.argv[2];
-  const outputDir = (process.argv[3] && !process.argv[3].startsWith('-')) ? process.argv[3] : process.cwd();
-  if (!inputArg) { console.error("Usage: bun run decode <qrcodes_or_fragments_dir_or_file> [output_dir]"); process.exit(1); }
-  decode(inputArg, outputDir).catch((e) => { console.error(e.message || e); process.exit(1); });
+/** `decode <dir> --check [--verify]`: completeness from gitzipqr.index and the listing, no password or pixels. */
+async function checkDir(dir, verify) {
+  const r = await chunkIndex.check(path.resolve(dir), { verify });
+  console.log(`Archive:    ${r.header.name}${r.header.ext || ''} (fileId ${r.header.fileId})`);
+  console.log(`Symbols:    ${r.symbols - r.missing.length}/${r.symbols} present in ${r.images} images`);
+  if (r.missing.length) console.log(`Missing:    ${chunkIndex.describeMissing(r.missing)}`);
+  if (r.duplicates.length) console.log(`Duplicates: ${r.duplicates.length} (skipped when decoding)`);
+  if (r.extra.length) console.log(`Unlisted:   ${r.extra.length} file(s)`);
+  if (verify) console.log(`Corrupt:    ${r.corrupt.length ? r.corrupt.join(', ') : 'none'}`);
+  console.log(r.ok ? '\n✅ Complete' : '\n❌ Incomplete');
+  return r.ok;
 }
-module.exports = { decode };
+
+async function main(argv = process.argv.slice(2)) {
+  const inputArg = argv[0];
+  const outputDir = (argv[1] && !argv[1].startsWith('-')) ? argv[1] : process.cwd();
+  if (!inputArg) {
+    console.error("Usage: bun run decode <qrcodes_or_fragments_dir_or_file> [output_dir] | <qrcodes_dir> --check [--verify]"
+      + " | <qrcodes_dir> <parts_dir> --shard i/n | <parts_dir> [output_dir] --merge");
+    process.exit(1);
+  }
+  if (argv.includes('--check')) {
+    let ok = false;
+    try { ok = await checkDir(inputArg, argv.includes('--verify')); } catch (e) { console.error(e.message || e); }
+    process.exit(ok ? 0 : 1);
+  }
+  let shard;
+  try { shard = sharding.fromArgv(argv); } catch (e) { console.error(e.message); process.exit(1); }
+  await decode(inputArg, outputDir, undefined, { shard, merge: argv.includes('--merge') }).catch((e) => { console.error(e.message || e); process.exit(1); });
+}
+
+if (require.main === module) main();
+module.exports = { decode, createDecodePool, checkDir, main };
@@ -8,9 +8,19 @@ const os = require('os');
 const path = require('path');
 const crypto = require('crypto');
 const archiver = require('archiver');
-const { Worker } = require('worker_threads');
 const { spawnSync } = require('child_process');
 const readline = require('readline');
+const { WorkerPool, workerPath } = require('./pool');
+const symbology = require('./symbology');
+const { FRAGMENT_TYPE, KCV_LABEL, encodeFrame, frameOverhead } = require('../shared/frame');
+const { Encoder: FountainEncoder } = require('../shared/fountain');
+const { writeApng } = require('./apng');
+const resources = require('./resources');
+const hashing = require('./hash');
+const chunkIndex = require('./chunkindex');
+const canonicalZip = require('./zip');
+const layout = require('./layout');
+const sharding = require('./shard');
 
 function scryptAsync(password, salt, keylen, opts) {
   return new Promise((resolve, reject) => {
@@ -23,13 +33,34 @@ function scryptAsync(password, salt, keylen, opts) {
 const SCRYPT = {
   N: parseInt(process.env.SCRYPT_N || (1 << 15), 10),
   r: parseInt(process.env.SCRYPT_r || 8, 10),
-  p: parseInt(process.env.SCRYPT_p || String(os.cpus().length), 10),
+  p: parseInt(process.env.SCRYPT_p || String(resources.cpuCount().count), 10),
   keyLen: 32
 };
-const FRAGMENT_TYPE = "GitZipQR-CHUNK-ENC";
 const ECL = (process.env.QR_ECL || 'Q').toUpperCase();
 const MARGIN = parseInt(process.env.QR_MARGIN || '1', 10);
-const MAX_WORKERS = Math.max(1, parseInt(process.env.QR_WORKERS || String(os.cpus().length), 10));
+// json: metadata + dataB64 as text (readable by every decoder version);
+// binary: GZQR frames in byte mode, the format the browser emits (+33% data per QR).
+const QR_FRAME = (process.env.QR_FRAME || 'json').toLowerCase();
+// Symbol size and linked symbols per chunk: QR_PARTS > 1 splits every chunk over up to
+// 16 smaller symbols (like Structured Append); only part 0 carries the full metadata.
+const QR_VERSION = Math.min(40, Math.max(1, parseInt(process.env.QR_VERSION || '40', 10)));
+const QR_PARTS = Math.min(16, Math.max(1, parseInt(process.env.QR_PARTS || '1', 10)));
+const MAX_PARTS = 16;
+// png: one static QR per chunk; frames: fountain-coded frame-NNNNNN.png sequence;
+// apng: the same droplets as one looping qrcodes.apng at QR_FPS for screen-to-camera transfer.
+const QR_OUTPUT = (process.env.QR_OUTPUT || 'png').toLowerCase();
+const QR_FPS = Math.min(255, Math.max(1, parseInt(process.env.QR_FPS || '10', 10)));
+// mono: one symbol per PNG; rgb: three symbols per PNG, one in each color channel
+// (digital archives only: print/camera color shifts break the channel separation).
+const QR_COLOR = (process.env.QR_COLOR || 'mono').toLowerCase();
+// Image backend (core/symbology.ts): qr, or grid for lossless digital-only storage.
+const SYMBOLOGY = (process.env.QR_SYMBOLOGY || 'qr').toLowerCase();
+// Sidecar gitzipqr.index (core/chunkindex.ts): image -> chunk, chunk hash, image hash.
+const QR_INDEX = /^(1|true|yes)$/i.test(process.env.QR_INDEX || '');
+const FOUNTAIN_OVERHEAD = Math.max(0, parseFloat(process.env.FOUNTAIN_OVERHEAD || '0.5')); // extra droplets over k
+// Pool size from CPU quota and memory limit (core/resources.ts); QR_WORKERS pins it.
+const PLAN = resources.plan('encode', SCRYPT);
+const MAX_WORKERS = PLAN.workers;
 
 function promptHidden(question) {
   return new Promise((resolve, reject) => {
@@ -70,37 +101,45 @@ async function promptPasswords(defaultCount = 2) {
 function stepStart(n, label) { process.stdout.write(`STEP #${n} ${label} ... `); }
 function stepDone(ok) { process.stdout.write(`[${ok ? 1 : 0}]\n`); }
 
-async function sha256File(p) {
-  return new Promise((resolve, reject) => {
-    const h = crypto.createHash('sha256');
-    const s = fs.createReadStream(p);
-    s.on('error', reject);
-    s.on('end', () => resolve(h.digest('hex')));
-    s.on('data', d => h.update(d));
-  });
+let qrencodeAvailable = null;
+function hasQrencode() {
+  if (qrencodeAvailable === null) qrencodeAvailable = spawnSync('qrencode', ['--version'], { stdio: 'ignore' }).status === 0;
+  return qrencodeAvailable;
 }
-function hasQrencode() { return spawnSync('qrencode', ['--version'], { stdio: 'ignore' }).status === 0; }
-function runWorker(task) {
-  return new Promise((resolve) => {
-    const w = new Worker(path.join(__dirname, 'qr.worker.ts'), { workerData: task });
-    w.once('message', (msg) => resolve(msg));
-    w.once('error', (err) => resolve({ ok: false, error: String(err && err.message || err) }));
-  });
+function createEncodePool(size = MAX_WORKERS) { return resources.govern(new WorkerPool(workerPath('qr.worker.ts'), size)); }
+async function runPool(tasks, pool) {
+  let ok = 0, fail = 0;
+  const total = tasks.length;
+  const results = await Promise.all(tasks.map(t => pool.run(t).then((res) => {
+    if (res && res.ok) ok++; else fail++;
+    if ((ok + fail) % 50 === 0 || ok + fail === total) process.stdout.write(`QR ${ok + fail}/${total} completed\r`);
+    return res;
+  })));
+  if (total) process.stdout.write('\n');
+  return { ok, fail, results };
 }
-async function runPool(tasks) {
-  let i = 0, active = 0, ok = 0, fail = 0;
-  return new Promise((resolve) => {
-    const total = tasks.length;
-    function launch() {
-      while (active < MAX_WORKERS && i < total) {
-        const t = tasks[i++]; active++;
-        runWorker(t).then((res) => {
-          active--; if (res && res.ok) ok++; else fail++;
-          if ((ok + fail) % 50 === 0 || ok + fail === total) process.stdout.write(`QR ${ok + fail}/${total} completed\r`);
-          if (i < total) launch(); else if (active === 0) { process.stdout.write('\n'); resolve({ ok, fail }); }
-        });
-      }
-    } launch();
+
+/* ---- Fountain output ---- */
+// Reads source block i of the encrypted file, zero-padded to blockSize.
+function blockReader(fd, size, blockSize) {
+  return (i) => {
+    const b = Buffer.alloc(blockSize);
+    fs.readSync(fd, b, 0, Math.min(blockSize, size - i * blockSize), i * blockSize);
+    return b;
+  };
+}
+// Pastes rendered PNGs (possibly of different sizes) top-left on white frames of one size.
+async function framesToApng(pngPaths, outPath, fps) {
+  const { PNG } = require('pngjs');
+  const dims = pngPaths.map((p) => { const h = readHead(p, 24); return [h.readUInt32BE(16), h.readUInt32BE(20)]; });
+  const width = Math.max(...dims.map(d => d[0])), height = Math.max(...dims.map(d => d[1]));
+  await writeApng(outPath, pngPaths.length, width, height, fps, (i) => {
+    const png = PNG.sync.read(fs.readFileSync(pngPaths[i]));
+    const gray = new Uint8Array(width * height).fill(255);
+    for (let y = 0; y < png.height; y++) {
+      for (let x = 0; x < png.width; x++) gray[y * width + x] = png.data[(y * png.width + x) * 4];
+    }
+    return { gray };
   });
 }
 
@@ -120,8 +159,24 @@ function readHead(filePath, n = 16) {
 }
 
 /* ---------------- Main API ---------------- */
-async function encode(inputPath, outputDir = path.join(process.cwd(), 'qrcodes'), passwords) {
+/**
+ * opts.pool — a WorkerPool from createEncodePool() to reuse across calls
+ * (the daemon keeps one warm); without it a pool is created and torn down here.
+ * opts.shard — { i, n } from `--shard i/n`: render only this host's chunk range (core/shard.ts).
+ * opts.shardSeed — the seed bytes every shard of this encode shares (`--shard-seed`).
+ * The temp directory (plaintext copy/zip, payload.enc) is removed however the run ends.
+ */
+async function encode(inputPath, outputDir = path.join(process.cwd(), 'qrcodes'), passwords, opts = {}) {
+  const tmpRoot = fs.mkdtempSync(path.join(os.tmpdir(), 'gitzipqr-'));
+  try { return await encodeIn(tmpRoot, inputPath, outputDir, passwords, opts); }
+  finally { fs.rmSync(tmpRoot, { recursive: true, force: true }); }
+}
+
+async function encodeIn(tmpRoot, inputPath, outputDir, passwords, opts) {
   const qrDir = outputDir;
+  const shard = opts.shard || null, shardSeed = shard ? opts.shardSeed : null;
+  if (shard && !shardSeed) throw new Error('--shard needs --shard-seed <hex> (or QR_SHARD_SEED): one random seed shared by every host, e.g. openssl rand -hex 32');
+  if (shard && !process.env.SCRYPT_p) throw new Error('--shard needs SCRYPT_p set to the same value on every host');
   if (!fs.existsSync(qrDir)) fs.mkdirSync(qrDir, { recursive: true });
 
   // STEP 1: password
@@ -131,9 +186,19 @@ async function encode(inputPath, outputDir = path.join(process.cwd(), 'qrcodes')
   catch (e) { stepDone(0); throw e; }
   stepDone(1);
 
+  // The key only depends on passphrase and salt: derive it on the libuv threadpool
+  // while STEP 2 zips/copies the input, and pick it up in STEP 3.
+  // Shards take salt and nonce from the shared seed instead, so every host gets the
+  // same ciphertext (the nonce also covers the data, in STEP 3).
+  const kdf = SCRYPT;
+  const salt = shard ? crypto.createHmac('sha256', shardSeed).update('GitZipQR shard salt').digest().subarray(0, 16) : crypto.randomBytes(16);
+  let nonce = shard ? null : crypto.randomBytes(12);
+  // Inside the promise, so a bad SCRYPT_* setting fails STEP 3 like any KDF error.
+  const keyJob = Promise.resolve().then(() => scryptAsync(PASSPHRASE, salt, 32, resources.scryptOptions(kdf)));
+  keyJob.catch(() => {}); // surfaced in STEP 3; avoids an unhandled rejection if STEP 2 fails first
+
   // STEP 2: prepare data
   stepStart(2, 'prepare data');
-  const tmpRoot = fs.mkdtempSync(path.join(os.tmpdir(), 'gitzipqr-'));
   const absInput = path.resolve(inputPath);
   const stInput = fs.statSync(absInput);
 
@@ -151,7 +216,9 @@ async function encode(inputPath, outputDir = path.join(process.cwd(), 'qrcodes')
     const archiveNameOnDisk = nameBase + '.zip';
     dataPath = path.join(tmpRoot, archiveNameOnDisk);
     try {
-      await new Promise((resolve, reject) => {
+      // Shards must zip byte-identically on every host: sorted, store-only (core/zip.ts).
+      if (shard) canonicalZip.writeCanonical(absInput, dataPath);
+      else await new Promise((resolve, reject) => {
         const out = fs.createWriteStream(dataPath);
         const ar = archiver('zip', { zlib: { level: 9 } });
         out.on('close', resolve); ar.on('warning', reject); ar.on('error', reject);
@@ -178,11 +245,17 @@ async function encode(inputPath, outputDir = path.join(process.cwd(), 'qrcodes')
 
   // STEP 3: encrypt
   stepStart(3, 'encrypt');
-  const salt = crypto.randomBytes(16);
-  const nonce = crypto.randomBytes(12);
-  let encPath;
+  let encPath, kcv;
   try {
-    const key = await scryptAsync(PASSPHRASE, salt, 32, { N: SCRYPT.N, r: SCRYPT.r, p: SCRYPT.p, maxmem: 512 * 1024 * 1024 });
+    if (shard) {
+      const dataHash = await new Promise((resolve, reject) => {
+        const h = crypto.createHash('sha256');
+        fs.createReadStream(dataPath).on('error', reject).on('data', d => h.update(d)).on('end', () => resolve(h.digest()));
+      });
+      nonce = crypto.createHmac('sha256', shardSeed).update('GitZipQR shard nonce').update(dataHash).digest().subarray(0, 12);
+    }
+    const key = await keyJob;
+    kcv = crypto.createHmac('sha256', key).update(KCV_LABEL).digest('hex').slice(0, 16);
     const cipher = crypto.createCipheriv('aes-256-gcm', key, nonce);
     encPath = path.join(tmpRoot, 'payload.enc');
     await new Promise((resolve, reject) => {
@@ -197,87 +270,208 @@ async function encode(inputPath, outputDir = path.join(process.cwd(), 'qrcodes')
 
   // STEP 4: calibrate capacity
   stepStart(4, 'calibrate QR capacity');
-  const cipherSha256 = await sha256File(encPath);
+  // Chunk and archive hashes use QR_HASH (core/hash.ts); blake3 payloads are version 3.3.
+  // They are filled in by one hashing pass in STEP 5: calibration only needs their lengths.
+  const HASH = hashing.ALG;
+  let cipherHash = ''.padStart(64, '0');
+  const blake = HASH === 'blake3';
   const baseMeta = {
     type: FRAGMENT_TYPE,
-    version: "3.1-inline-only",
-    fileId: crypto.createHash('sha256').update(nameBase + ':' + cipherSha256).digest('hex').slice(0, 16),
+    version: QR_FRAME === 'binary' ? (blake ? "3.3-binary-blake3" : "3.2-binary") : (blake ? "3.3-inline-blake3" : "3.1-inline-only"),
+    fileId: ''.padStart(16, '0'),
     name: nameBase,            // always without extension
     ext: metaExt || '',        // always original extension (or .zip for directories)
     chunk: 0, total: 1,
     hash: ''.padStart(64, '0'),
-    cipherHash: cipherSha256,
-    kdfParams: { N: SCRYPT.N, r: SCRYPT.r, p: SCRYPT.p },
+    cipherHash,
+    ...(blake ? { hashAlg: 'blake3' } : {}),
+    kdfParams: { N: kdf.N, r: kdf.r, p: kdf.p },
     saltB64: salt.toString('base64'),
     nonceB64: nonce.toString('base64'),
+    kcv,
+    ...(SYMBOLOGY !== 'qr' ? { sym: SYMBOLOGY } : {}),
     chunkSize: 0
   };
-  let maxDataB64;
+  // Linked parts after the first carry only what is needed to place them.
+  const partMeta = (chunk, part, partTotal) => ({ type: FRAGMENT_TYPE, fileId: baseMeta.fileId, chunk, part, partTotal });
+  let firstPart, nextPart; // chunk bytes carried by part 0 / by each later part
+  // Fountain droplets carry the archive metadata plus { k, len, seed } instead of chunk fields.
+  const dropletMeta = (fountain) => {
+    const { chunk: _c, total: _t, hash: _h, chunkSize: _s, ...archiveMeta } = baseMeta;
+    return { ...archiveMeta, fountain };
+  };
+  let dropletSize;
   try {
-    const CAPACITY = { L: 2953, M: 2331, Q: 1663, H: 1273 }; // bytes for QR version 40
-    const maxBytes = CAPACITY[ECL] || CAPACITY.Q;
-    const overhead = Buffer.byteLength(JSON.stringify({ ...baseMeta, dataB64: '' }), 'utf8');
-    maxDataB64 = maxBytes - overhead;
-    if (maxDataB64 <= 0) throw new Error('metadata too large for chosen error correction level');
+    hashing.check(HASH);
+    const maxBytes = symbology.get(SYMBOLOGY).capacity({ version: QR_VERSION, ecl: ECL });
+    if (QR_FRAME !== 'json' && QR_FRAME !== 'binary') throw new Error(`QR_FRAME must be json or binary, got ${QR_FRAME}`);
+    const overhead = (meta) => QR_FRAME === 'binary'
+      ? frameOverhead(meta)
+      : Buffer.byteLength(JSON.stringify({ ...meta, dataB64: '' }), 'utf8');
+    const fit = (meta) => {
+      const room = maxBytes - overhead(meta);
+      return Math.floor((QR_FRAME === 'binary' ? room : room * 3 / 4) * 0.98);
+    };
+    const wide = { chunk: 999999, total: 999999, ...(QR_PARTS > 1 ? { part: 0, partTotal: MAX_PARTS } : {}) };
+    firstPart = fit({ ...baseMeta, ...wide });
+    nextPart = fit(partMeta(999999, MAX_PARTS - 1, MAX_PARTS));
+    dropletSize = fit(dropletMeta({ k: 999999, len: 99999999999, seed: 9999999 }));
+    if (!['png', 'frames', 'apng'].includes(QR_OUTPUT)) throw new Error(`QR_OUTPUT must be png, frames or apng, got ${QR_OUTPUT}`);
+    if (!['mono', 'rgb'].includes(QR_COLOR)) throw new Error(`QR_COLOR must be mono or rgb, got ${QR_COLOR}`);
+    if (QR_COLOR === 'rgb' && SYMBOLOGY !== 'qr') throw new Error('QR_COLOR=rgb needs QR_SYMBOLOGY=qr');
+    if (QR_COLOR === 'rgb' && QR_OUTPUT === 'apng') throw new Error('QR_COLOR=rgb does not apply to grayscale APNG output');
+    if (QR_INDEX && QR_OUTPUT !== 'png') throw new Error('QR_INDEX needs QR_OUTPUT=png (fountain frames are interchangeable)');
+    if (firstPart <= 0 || nextPart <= 0 || dropletSize <= 0) throw new Error(`metadata too large for QR version ${QR_VERSION} at ECL ${ECL}`);
     stepDone(1);
   } catch (e) {
     stepDone(0);
     throw new Error('Calibration failed: ' + (e.message || e));
   }
 
-  const idealChunk = Math.max(512, Math.floor(maxDataB64 * 3 / 4 * 0.98));
+  const idealChunk = firstPart + (QR_PARTS - 1) * nextPart;
   const CHUNK_SIZE = parseInt(process.env.CHUNK_SIZE || String(idealChunk), 10);
   baseMeta.chunkSize = CHUNK_SIZE;
 
   // STEP 5: chunk & queue
-  stepStart(5, `chunk & queue jobs (chunk_size=${CHUNK_SIZE}, ECL=${ECL}, workers=${MAX_WORKERS}${hasQrencode() ? ', native=qrencode' : ''})`);
+  const FOUNTAIN = QR_OUTPUT !== 'png';
+  const blockSize = FOUNTAIN ? parseInt(process.env.CHUNK_SIZE || String(dropletSize), 10) : CHUNK_SIZE;
+  stepStart(5, FOUNTAIN
+    ? `fountain-code frames (block_size=${blockSize}, overhead=${FOUNTAIN_OVERHEAD}, output=${QR_OUTPUT}, ECL=${ECL}, workers=${MAX_WORKERS})`
+    : `chunk & queue jobs (chunk_size=${CHUNK_SIZE}, version=${QR_VERSION}, parts=${QR_PARTS}, ECL=${ECL}, workers=${MAX_WORKERS}${hasQrencode() ? ', native=qrencode' : ''})`);
   const st = fs.statSync(encPath);
-  const totalChunks = Math.ceil(st.size / CHUNK_SIZE);
-  const fileId = baseMeta.fileId;
+  const totalChunks = Math.ceil(st.size / blockSize);
+  let fileId;
   const fd = fs.openSync(encPath, 'r');
-  const tasks = [];
+  let tasks = [];
+  const frameDir = QR_OUTPUT === 'apng' ? path.join(tmpRoot, 'frames') : qrDir; // apng frames are temporary
+  if (frameDir !== qrDir) fs.mkdirSync(frameDir, { recursive: true });
+  // Fountain: k systematic droplets first, then FOUNTAIN_OVERHEAD * k repair droplets.
+  const frames = FOUNTAIN ? Math.ceil(totalChunks * (1 + FOUNTAIN_OVERHEAD)) : 0;
+  // This host's chunks (or seeds); everything when not sharded.
+  const [from, to] = shard ? sharding.range(FOUNTAIN ? frames : totalChunks, shard) : [0, FOUNTAIN ? frames : totalChunks];
+  let perChunk = 1; // symbols of a full chunk, for global image numbers
   try {
-    for (let i = 0; i < totalChunks; i++) {
+    // Archive and chunk digests in one pass, on the hash workers for large blake3 payloads.
+    const ranges = [];
+    for (let i = from; i < (FOUNTAIN ? from : to); i++) ranges.push([i * CHUNK_SIZE, Math.min(CHUNK_SIZE, st.size - i * CHUNK_SIZE)]);
+    const { whole, chunks: digests } = await hashing.hashAll(HASH, encPath, st.size, ranges);
+    cipherHash = baseMeta.cipherHash = whole;
+    fileId = baseMeta.fileId = crypto.createHash('sha256').update(nameBase + ':' + cipherHash).digest('hex').slice(0, 16);
+    const fountain = new FountainEncoder(totalChunks, blockSize, blockReader(fd, st.size, blockSize));
+    if (!FOUNTAIN && CHUNK_SIZE > firstPart) perChunk = 1 + Math.ceil((CHUNK_SIZE - firstPart) / nextPart);
+    for (let seed = from; seed < (FOUNTAIN ? to : from); seed++) {
+      const buf = fountain.droplet(seed);
+      const meta = dropletMeta({ k: totalChunks, len: st.size, seed });
+      const content = QR_FRAME === 'binary'
+        ? { data: encodeFrame(meta, buf) }
+        : { text: JSON.stringify({ ...meta, dataB64: Buffer.from(buf).toString('base64') }) };
+      const outPath = path.join(frameDir, `frame-${String(seed).padStart(6, '0')}.png`);
+      tasks.push({ outPath, pos: seed, ...content, symbology: SYMBOLOGY, useQrencode: SYMBOLOGY === 'qr' && hasQrencode(), ecl: ECL, margin: MARGIN });
+    }
+    for (let i = from; i < (FOUNTAIN ? from : to); i++) {
       const start = i * CHUNK_SIZE, end = Math.min(start + CHUNK_SIZE, st.size);
       const buf = Buffer.alloc(end - start); fs.readSync(fd, buf, 0, buf.length, start);
-      const chunkHash = crypto.createHash('sha256').update(buf).digest('hex');
-      const payload = {
-        ...baseMeta,
-        chunk: i,
-        total: totalChunks,
-        hash: chunkHash,
-        dataB64: buf.toString('base64')
-      };
-      const outPath = path.join(qrDir, `qr-${String(i).padStart(6, '0')}.png`);
-      tasks.push({ outPath, text: JSON.stringify(payload), useQrencode: hasQrencode(), ecl: ECL, margin: MARGIN });
+      const chunkHash = digests[i - from];
+      // The hash covers the whole chunk; parts are plain consecutive slices of it.
+      const partTotal = buf.length <= firstPart ? 1 : 1 + Math.ceil((buf.length - firstPart) / nextPart);
+      if (partTotal > MAX_PARTS) throw new Error(`chunk ${i} needs ${partTotal} symbols (max ${MAX_PARTS}); lower CHUNK_SIZE`);
+      for (let p = 0; p < partTotal; p++) {
+        const partFrom = p === 0 ? 0 : firstPart + (p - 1) * nextPart;
+        const slice = buf.subarray(partFrom, p === 0 ? firstPart : partFrom + nextPart);
+        const meta = p === 0
+          ? { ...baseMeta, chunk: i, total: totalChunks, hash: chunkHash, ...(partTotal > 1 ? { part: 0, partTotal } : {}) }
+          : partMeta(i, p, partTotal);
+        const suffix = partTotal > 1 ? `-${String(p).padStart(2, '0')}` : '';
+        const outPath = path.join(qrDir, `qr-${String(i).padStart(6, '0')}${suffix}.png`);
+        const content = QR_FRAME === 'binary'
+          ? { data: encodeFrame(meta, slice) }
+          : { text: JSON.stringify({ ...meta, dataB64: slice.toString('base64') }) };
+        tasks.push({
+          outPath, pos: i * perChunk + p, ...content, symbology: SYMBOLOGY, useQrencode: SYMBOLOGY === 'qr' && hasQrencode(), ecl: ECL, margin: MARGIN,
+          ...(QR_INDEX ? { hashImage: true, refs: [{ chunk: i, part: p, partTotal, hash: chunkHash }] } : {}),
+        });
+      }
     }
     stepDone(1);
   } catch (e) { stepDone(0); throw new Error('Chunking failed: ' + (e.message || e)); }
   finally { fs.closeSync(fd); }
 
+  // QR_COLOR=rgb: three consecutive symbols share one image (rendered by the JS path).
+  // Shards name each image after its first symbol, so names stay unique across hosts.
+  const symbols = tasks.length;
+  if (QR_COLOR === 'rgb') {
+    const grouped = [];
+    for (let i = 0; i < tasks.length; i += 3) {
+      const name = FOUNTAIN ? 'frame' : 'qr';
+      grouped.push({
+        outPath: shard ? tasks[i].outPath : path.join(frameDir, `${name}-${String(i / 3).padStart(6, '0')}.png`),
+        pos: Math.floor(tasks[i].pos / 3),
+        channels: tasks.slice(i, i + 3).map(t => t.data || t.text), ecl: ECL, margin: MARGIN,
+        ...(QR_INDEX ? { hashImage: true, refs: tasks.slice(i, i + 3).flatMap(t => t.refs) } : {}),
+      });
+    }
+    tasks = grouped;
+  }
+
+  // QR_SHARD_FANOUT: spread the images over nested numbered directories (core/layout.ts),
+  // by global image number so that shards fill the same tree.
+  if (layout.FANOUT > 1 && frameDir === qrDir) {
+    const place = layout.placer(qrDir);
+    tasks.forEach((t) => { t.outPath = place(t.pos, path.basename(t.outPath)); });
+  }
+
   // STEP 6: encode QR in parallel
   stepStart(6, 'encode QR in parallel');
-  const { ok, fail } = await runPool(tasks);
+  const pool = opts.pool || createEncodePool();
+  let ok, fail, results;
+  try { ({ ok, fail, results } = await runPool(tasks, pool)); }
+  finally { if (!opts.pool) await pool.destroy(); }
   stepDone(fail === 0);
   if (fail) throw new Error(`Some QR tasks failed: ${fail}`);
+
+  let output = qrDir, indexPath = null;
+  if (QR_INDEX) {
+    stepStart('6b', `write chunk index (${chunkIndex.indexName(shard)})`);
+    try {
+      const entries = tasks.flatMap((t, k) => t.refs.map(r => ({ file: layout.relative(qrDir, t.outPath), sha256: results[k].sha256, ...r })));
+      const { name, ext, hashAlg = 'sha256' } = baseMeta;
+      indexPath = chunkIndex.write(qrDir, { fileId, name, ext, total: totalChunks, hashAlg, ...(shard ? { shard, from, to } : {}) }, entries);
+      stepDone(1);
+    } catch (e) { stepDone(0); throw new Error('Index failed: ' + (e.message || e)); }
+  }
+  if (QR_OUTPUT === 'apng') {
+    stepStart('6b', `assemble APNG (${tasks.length} frames @ ${QR_FPS} fps)`);
+    output = path.join(qrDir, 'qrcodes.apng');
+    try { await framesToApng(tasks.map(t => t.outPath), output, QR_FPS); stepDone(1); }
+    catch (e) { stepDone(0); throw new Error('APNG failed: ' + (e.message || e)); }
+    finally { fs.rmSync(frameDir, { recursive: true, force: true }); }
+  }
   console.log(`Support me please USDT money -${process.env.USDT_ADDRESS}`)
 
   // STEP 7: summary
   console.log('\nDone.');
-  console.log(`QRCodes:    ${qrDir}`);
-  console.log(`Mode:       QR-ONLY (inline), ECL=${ECL}, workers=${MAX_WORKERS}${hasQrencode() ? ', native=qrencode' : ''}`);
+  console.log(`QRCodes:    ${output}${layout.FANOUT > 1 && QR_OUTPUT !== 'apng' ? ` (sharded: fan-out ${layout.FANOUT}, depth ${layout.DEPTH})` : ''}`);
+  console.log(`Mode:       ${FOUNTAIN ? `FOUNTAIN (${QR_OUTPUT})` : 'QR-ONLY (inline)'}, symbology=${SYMBOLOGY}, ECL=${ECL}, workers=${MAX_WORKERS}${hasQrencode() ? ', native=qrencode' : ''}`);
+  console.log(`Resources:  ${resources.describe(PLAN)}`);
   console.log(`FileID:     ${fileId}`);
-  console.log(`Chunks:     ${totalChunks}`);
+  if (shard) console.log(`Shard:      ${shard.i}/${shard.n}, ${FOUNTAIN ? 'frames' : 'chunks'} ${from}..${to - 1} of ${FOUNTAIN ? frames : totalChunks}`);
+  if (blake) console.log(`Hash:       blake3 ${cipherHash}`);
+  console.log(`Chunks:     ${totalChunks}${symbols > totalChunks ? ` (${symbols} ${FOUNTAIN ? 'frames' : 'symbols'})` : ''}`);
+  if (QR_COLOR === 'rgb') console.log(`Images:     ${tasks.length} (RGB, 3 symbols each)`);
+  if (indexPath) console.log(`Index:      ${indexPath}`);
   console.log(`Support me please USDT money - ${process.env.USDT_ADDRESS}`)
 
   return { qrDir, fileId, totalChunks, nameBase, metaExt };
 }
 
-if (require.main === module) {
-  const argv = process.argv.slice(2);
+async function main(argv = process.argv.slice(2)) {
   const input = argv[0];
   const outDir = argv[1] && !argv[1].startsWith('-') ? argv[1] : undefined;
-  if (!input) { console.error('Usage: bun run encode <input_file_or_dir> [output_dir]'); process.exit(1); }
-  encode(input, outDir).catch((e) => { console.error(e.message || e); process.exit(1); });
+  if (!input) { console.error('Usage: bun run encode <input_file_or_dir> [output_dir] [--shard i/n --shard-seed <hex>]'); process.exit(1); }
+  let shard, shardSeed;
+  try { shard = sharding.fromArgv(argv); shardSeed = sharding.seedFromArgv(argv); } catch (e) { console.error(e.message); process.exit(1); }
+  await encode(input, outDir, undefined, { shard, shardSeed }).catch((e) => { console.error(e.message || e); process.exit(1); });
 }
-module.exports = { encode };
+
+if (require.main === module) main();
+module.exports = { encode, createEncodePool, main };
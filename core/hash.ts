@@ -0,0 +1,104 @@
+/**
+ * GitZipQR — Chunk and archive hashing
+ * QR_HASH=sha256 (default) keeps the "3.1"/"3.2" payloads: SHA-256 per chunk
+ * and one serial SHA-256 over the whole ciphertext.
+ * QR_HASH=blake3 writes "3.3" payloads (meta.hashAlg = 'blake3'): the chunk and
+ * archive hashes are BLAKE3 (shared/blake3.js). BLAKE3 is a tree hash, so above
+ * PARALLEL_MIN the ciphertext is cut into 1 MiB subtrees that hash.worker.ts
+ * hashes on every core. The subtree values are then folded into the archive
+ * digest. The chunk digests are computed in the same worker-pool run: encode
+ * and decode each make one hashAll call for the archive and all chunk ranges.
+ *
+ * A source is a file path, or bytes backed by a SharedArrayBuffer (which
+ * workers read without a copy).
+ */
+const fs = require('fs');
+const crypto = require('crypto');
+const { WorkerPool, workerPath } = require('./pool');
+const blake3 = require('../shared/blake3');
+const resources = require('./resources');
+
+const ALG = (process.env.QR_HASH || 'sha256').toLowerCase();
+const PARALLEL_MIN = 8 * blake3.SUBTREE;
+let local = null; // in-process BLAKE3 instance, for inputs below PARALLEL_MIN
+
+function check(alg) {
+  if (alg !== 'sha256' && alg !== 'blake3') throw new Error(`QR_HASH must be sha256 or blake3, got ${alg}`);
+  return alg;
+}
+
+/** Hex digest of bytes. */
+function digest(alg, bytes) {
+  if (alg !== 'blake3') return crypto.createHash('sha256').update(bytes).digest('hex');
+  if (!local) local = blake3.create();
+  return blake3.toHex(local.hash(bytes));
+}
+
+function sha256File(p) {
+  return new Promise((resolve, reject) => {
+    const h = crypto.createHash('sha256');
+    const s = fs.createReadStream(p);
+    s.on('error', reject);
+    s.on('end', () => resolve(h.digest('hex')));
+    s.on('data', d => h.update(d));
+  });
+}
+
+function readRange(source, offset, length) {
+  if (typeof source !== 'string') return source.subarray(offset, offset + length);
+  const buf = Buffer.alloc(length), fd = fs.openSync(source, 'r');
+  try { fs.readSync(fd, buf, 0, length, offset); } finally { fs.closeSync(fd); }
+  return buf;
+}
+
+// Tasks for hash.worker.ts carry the file path or the SharedArrayBuffer view itself.
+const where = (source) => typeof source === 'string'
+  ? { path: source }
+  : { sab: source.buffer, base: source.byteOffset };
+
+/**
+ * One pass over a source: { whole, chunks }, where whole is the digest of its
+ * first `size` bytes (skipped when size is null) and chunks[i] the digest of
+ * ranges[i] = [offset, length].
+ */
+async function hashAll(alg, source, size, ranges = []) {
+  const bytes = (size || 0) + ranges.reduce((n, r) => n + r[1], 0);
+  const cpus = resources.cpuCount().count;
+  if (alg !== 'blake3' || bytes < PARALLEL_MIN || cpus < 2) {
+    const chunks = ranges.map(([off, len]) => digest(alg, readRange(source, off, len)));
+    const whole = size == null ? null
+      : typeof source === 'string' && alg !== 'blake3' ? await sha256File(source) : digest(alg, readRange(source, 0, size));
+    return { whole, chunks };
+  }
+  const pool = new WorkerPool(workerPath('hash.worker.ts'), cpus);
+  try {
+    const at = where(source), SUB = blake3.SUBTREE;
+    const subtrees = [];
+    for (let off = 0; off < (size || 0); off += SUB) {
+      subtrees.push(pool.run({ op: 'subtree', ...at, offset: off, length: Math.min(SUB, size - off), counter: off / blake3.CHUNK }));
+    }
+    // Chunk digests in batches of about one subtree's worth of bytes.
+    const batches = [];
+    for (let i = 0, bytes = 0, start = 0; i <= ranges.length; i++) {
+      if (i === ranges.length || bytes >= SUB) {
+        if (i > start) batches.push(pool.run({ op: 'chunks', ...at, ranges: ranges.slice(start, i) }));
+        start = i; bytes = 0;
+      }
+      if (i < ranges.length) bytes += ranges[i][1];
+    }
+    const results = await Promise.all([...subtrees, ...batches]);
+    const failed = results.find(r => !r.ok);
+    if (failed) throw new Error('hash worker: ' + failed.error);
+    if (!local) local = blake3.create();
+    return {
+      whole: size == null ? null
+        : subtrees.length > 1 ? blake3.toHex(local.combine(results.slice(0, subtrees.length).map(r => r.cv)))
+        : digest(alg, readRange(source, 0, size)),
+      chunks: results.slice(subtrees.length).flatMap(r => r.digests),
+    };
+  } finally {
+    await pool.destroy();
+  }
+}
+
+module.exports = { ALG, PARALLEL_MIN, check, digest, hashAll };
@@ -0,0 +1,51 @@
+/**
+ * BLAKE3 Hash Worker
+ * - subtree: chaining value of one 1 MiB-aligned range (read straight into the
+ *   kernel's input area) -> { cv }.
+ * - chunks:  digests of [offset, length] ranges -> { digests }.
+ * The source is task.path (a file) or task.sab + task.base (shared ciphertext).
+ * - Persistent: serves { id, task } messages from core/pool.ts until terminated.
+ */
+const fs = require('fs');
+const { parentPort } = require('worker_threads');
+const blake3 = require('../shared/blake3');
+
+const hasher = blake3.create();
+
+function read(task, offset, length, into) {
+  if (task.sab) {
+    const src = new Uint8Array(task.sab, task.base + offset, length);
+    if (!into) return src;
+    into.set(src);
+    return into;
+  }
+  const buf = into || Buffer.alloc(length);
+  const fd = fs.openSync(task.path, 'r');
+  try {
+    for (let off = 0; off < length;) {
+      const n = fs.readSync(fd, buf, off, length - off, offset + off);
+      if (!n) throw new Error('short read');
+      off += n;
+    }
+  } finally { fs.closeSync(fd); }
+  return buf;
+}
+
+function handle(task) {
+  try {
+    if (task.op === 'subtree') {
+      const bytes = read(task, task.offset, task.length, hasher.input(task.length));
+      return { ok: true, cv: hasher.subtree(bytes, task.counter) };
+    }
+    if (task.op === 'chunks') {
+      return { ok: true, digests: task.ranges.map(([off, len]) => blake3.toHex(hasher.hash(read(task, off, len)))) };
+    }
+    return { ok: false, error: `unknown op ${task.op}` };
+  } catch (e) {
+    return { ok: false, error: String(e && e.message || e) };
+  }
+}
+
+parentPort.on('message', ({ id, task }) => {
+  parentPort.postMessage({ id, ...handle(task) });
+});
@@ -0,0 +1,220 @@
+/**
+ * GitZipQR — Scaled grayscale JPEG decoder
+ * Baseline (SOF0/SOF1) Huffman JPEGs only. The entropy-coded data is read once
+ * and only the luma coefficients are kept. render(n) then produces a gray image
+ * at n/8 scale (n = 1, 2, 4 or 8) with an n x n IDCT over the low-frequency
+ * coefficients. At 1/8 that is just the DC term. There is no chroma upsampling,
+ * color conversion or RGBA buffer, which is all a QR reader needs from a phone photo.
+ * Progressive, arithmetic-coded, CMYK and Adobe-RGB files throw, and the
+ * caller falls back to jpeg-js.
+ */
+const ZIGZAG = Int32Array.from([
+  0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5, 12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+  35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51, 58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+]);
+
+// IDCT[n][x * n + u] = C(u) / 2 * cos((2x + 1) u pi / 2n); the 2-D pass over n x n coefficients
+// gives the n-point reconstruction of the block (n = 1: DC / 8, the block mean).
+const IDCT = {};
+for (const n of [1, 2, 4, 8]) {
+  const t = new Float32Array(n * n);
+  for (let x = 0; x < n; x++) for (let u = 0; u < n; u++) t[x * n + u] = (u ? 0.5 : Math.SQRT1_2 / 2) * Math.cos((2 * x + 1) * u * Math.PI / (2 * n));
+  IDCT[n] = t;
+}
+
+function huffmanTable(counts, symbols) {
+  const lookup = new Uint16Array(512); // 9-bit fast path: (length << 8) | symbol
+  const maxcode = new Int32Array(18).fill(-1), valptr = new Int32Array(17), mincode = new Int32Array(17);
+  let code = 0, k = 0;
+  for (let len = 1; len <= 16; len++) {
+    valptr[len] = k; mincode[len] = code;
+    for (let i = 0; i < counts[len - 1]; i++, k++, code++) {
+      if (len <= 9) for (let j = code << (9 - len), end = (code + 1) << (9 - len); j < end; j++) lookup[j] = (len << 8) | symbols[k];
+    }
+    maxcode[len] = counts[len - 1] ? code - 1 : -1;
+    code <<= 1;
+  }
+  return { lookup, maxcode, valptr, mincode, symbols };
+}
+
+function unsupported(what) { return new Error(`JPEG: ${what} not supported`); }
+
+/**
+ * Parses headers and entropy-decodes the luma plane: { width, height, render(n) }.
+ * alloc(slot, Type, length) supplies zeroed coefficient and pixel arrays (core/arena.ts in the worker).
+ */
+function open(buf, alloc = (slot, Type, length) => new Type(length)) {
+  if (buf[0] !== 0xff || buf[1] !== 0xd8) throw new Error('Not a JPEG file');
+  const qt = [], dc = [], ac = [];
+  let frame = null, restart = 0, pos = 2;
+
+  const u16 = (p) => (buf[p] << 8) | buf[p + 1];
+  // Bit reader over entropy-coded data: skips 0xFF00 stuffing, feeds zeros at a marker.
+  let bits = 0, nbits = 0;
+  const fill = () => {
+    while (nbits <= 24) {
+      let b = 0;
+      if (pos < buf.length) {
+        b = buf[pos];
+        if (b !== 0xff) pos++;
+        else if (buf[pos + 1] === 0) pos += 2;
+        else b = 0;
+      }
+      bits = ((bits << 8) | b) >>> 0; nbits += 8;
+    }
+  };
+  const getBits = (n) => { if (nbits < n) fill(); nbits -= n; return (bits >>> nbits) & ((1 << n) - 1); };
+  const extend = (v, s) => (v < 1 << (s - 1) ? v - (1 << s) + 1 : v);
+  const decode = (t) => {
+    if (nbits < 16) fill();
+    const hit = t.lookup[(bits >>> (nbits - 9)) & 511];
+    if (hit) { nbits -= hit >> 8; return hit & 0xff; }
+    for (let len = 10; len <= 16; len++) {
+      const code = (bits >>> (nbits - len)) & ((1 << len) - 1);
+      if (code <= t.maxcode[len]) { nbits -= len; return t.symbols[t.valptr[len] + code - t.mincode[len]]; }
+    }
+    throw new Error('JPEG: bad Huffman code');
+  };
+
+  const scratch = new Int16Array(64);
+  function decodeBlock(c, out, off) {
+    const s = decode(c.dc);
+    c.pred += s ? extend(getBits(s), s) : 0;
+    out[off] = c.pred;
+    for (let k = 1; k < 64;) {
+      const rs = decode(c.ac), r = rs >> 4, size = rs & 15;
+      if (!size) { if (r !== 15) break; k += 16; continue; }
+      k += r;
+      if (k > 63) break;
+      out[off + ZIGZAG[k]] = extend(getBits(size), size);
+      k++;
+    }
+  }
+
+  function scan(comps) {
+    const { hmax, vmax, width, height } = frame;
+    comps.forEach(c => { c.pred = 0; });
+    const single = comps.length === 1;
+    const mcusX = single ? Math.ceil(Math.ceil(width * comps[0].h / hmax) / 8) : Math.ceil(width / (8 * hmax));
+    const mcusY = single ? Math.ceil(Math.ceil(height * comps[0].v / vmax) / 8) : Math.ceil(height / (8 * vmax));
+    bits = 0; nbits = 0;
+    for (let m = 0, total = mcusX * mcusY; m < total; m++) {
+      if (restart && m && m % restart === 0) {
+        nbits = 0; bits = 0;
+        while (pos < buf.length && !(buf[pos] === 0xff && buf[pos + 1] >= 0xd0 && buf[pos + 1] <= 0xd7)) pos++;
+        pos += 2;
+        comps.forEach(c => { c.pred = 0; });
+      }
+      const mx = m % mcusX, my = (m / mcusX) | 0;
+      for (const c of comps) {
+        const hs = single ? 1 : c.h, vs = single ? 1 : c.v;
+        for (let v = 0; v < vs; v++) for (let h = 0; h < hs; h++) {
+          if (c !== frame.luma) { decodeBlock(c, scratch, 0); continue; }
+          decodeBlock(c, c.coefs, ((my * vs + v) * c.bw + mx * hs + h) * 64);
+        }
+      }
+    }
+    // resync on the next real marker
+    while (pos < buf.length && !(buf[pos] === 0xff && buf[pos + 1] !== 0 && !(buf[pos + 1] >= 0xd0 && buf[pos + 1] <= 0xd7))) pos++;
+  }
+
+  while (pos < buf.length) {
+    if (buf[pos] !== 0xff) { pos++; continue; }
+    const marker = buf[pos + 1];
+    if (marker === 0xff) { pos++; continue; }
+    pos += 2;
+    if (marker === 0xd9) break; // EOI
+    if (marker === 0x01 || (marker >= 0xd0 && marker <= 0xd7)) continue;
+    const len = u16(pos), end = pos + len;
+    if (marker === 0xdb) { // DQT
+      for (let p = pos + 2; p < end;) {
+        const wide = buf[p] >> 4, id = buf[p] & 15, q = new Int32Array(64);
+        p++;
+        for (let k = 0; k < 64; k++, p += wide ? 2 : 1) q[ZIGZAG[k]] = wide ? u16(p) : buf[p];
+        qt[id] = q;
+      }
+    } else if (marker === 0xc4) { // DHT
+      for (let p = pos + 2; p < end;) {
+        const cls = buf[p] >> 4, id = buf[p] & 15, counts = buf.subarray(p + 1, p + 17);
+        const n = counts.reduce((a, b) => a + b, 0);
+        (cls ? ac : dc)[id] = huffmanTable(counts, buf.subarray(p + 17, p + 17 + n));
+        p += 17 + n;
+      }
+    } else if (marker === 0xdd) { // DRI
+      restart = u16(pos + 2);
+    } else if (marker === 0xee && buf.toString('ascii', pos + 2, pos + 7) === 'Adobe' && buf[pos + 13] === 0) {
+      throw unsupported('Adobe RGB/CMYK');
+    } else if (marker === 0xc0 || marker === 0xc1) { // baseline / extended sequential
+      const height = u16(pos + 3), width = u16(pos + 5), n = buf[pos + 7];
+      if (n !== 1 && n !== 3) throw unsupported(`${n}-component image`);
+      const comps = [];
+      for (let i = 0; i < n; i++) {
+        const p = pos + 8 + i * 3;
+        comps.push({ id: buf[p], h: buf[p + 1] >> 4, v: buf[p + 1] & 15, tq: buf[p + 2] });
+      }
+      const hmax = Math.max(...comps.map(c => c.h)), vmax = Math.max(...comps.map(c => c.v));
+      const luma = comps[0];
+      if (luma.h !== hmax || luma.v !== vmax) throw unsupported('subsampled luma');
+      luma.bw = Math.ceil(width / (8 * hmax)) * hmax;
+      luma.bh = Math.ceil(height / (8 * vmax)) * vmax;
+      luma.coefs = alloc('jpeg-coefs', Int16Array, luma.bw * luma.bh * 64);
+      frame = { width, height, comps, hmax, vmax, luma };
+    } else if (marker >= 0xc2 && marker <= 0xcf && marker !== 0xc4 && marker !== 0xc8 && marker !== 0xcc) {
+      throw unsupported('progressive/arithmetic coding');
+    } else if (marker === 0xda) { // SOS
+      if (!frame) throw new Error('JPEG: scan before frame header');
+      const n = buf[pos + 2], comps = [];
+      for (let i = 0; i < n; i++) {
+        const c = frame.comps.find(x => x.id === buf[pos + 3 + i * 2]);
+        const t = buf[pos + 4 + i * 2];
+        c.dc = dc[t >> 4]; c.ac = ac[t & 15];
+        comps.push(c);
+      }
+      pos = end;
+      scan(comps);
+      continue;
+    }
+    pos = end;
+  }
+  if (!frame) throw new Error('JPEG: no frame');
+  const { width, height, luma } = frame;
+  const q = qt[luma.tq];
+
+  /** Gray image at n/8 scale: { gray, width, height }. */
+  function render(n = 8) {
+    if (!IDCT[n]) throw new Error(`JPEG: scale ${n}/8 not supported`);
+    const T = IDCT[n], outW = Math.ceil(width * n / 8), outH = Math.ceil(height * n / 8);
+    const gray = alloc('gray', Uint8Array, outW * outH), F = new Float32Array(n * n), tmp = new Float32Array(n * n);
+    const bw = Math.ceil(outW / n), bh = Math.ceil(outH / n);
+    for (let by = 0; by < bh; by++) for (let bx = 0; bx < bw; bx++) {
+      const off = (by * luma.bw + bx) * 64;
+      let ac = false;
+      for (let v = 0; v < n; v++) for (let u = 0; u < n; u++) {
+        const f = luma.coefs[off + v * 8 + u] * q[v * 8 + u];
+        F[v * n + u] = f;
+        if (f && (u || v)) ac = true;
+      }
+      const x0 = bx * n, y0 = by * n, xs = Math.min(n, outW - x0), ys = Math.min(n, outH - y0);
+      if (!ac) {
+        const val = Math.max(0, Math.min(255, Math.round(F[0] / 8 + 128)));
+        for (let y = 0; y < ys; y++) gray.fill(val, (y0 + y) * outW + x0, (y0 + y) * outW + x0 + xs);
+        continue;
+      }
+      for (let v = 0; v < n; v++) for (let x = 0; x < n; x++) {
+        let s = 0;
+        for (let u = 0; u < n; u++) s += F[v * n + u] * T[x * n + u];
+        tmp[v * n + x] = s;
+      }
+      for (let y = 0; y < ys; y++) for (let x = 0; x < xs; x++) {
+        let s = 0;
+        for (let v = 0; v < n; v++) s += tmp[v * n + x] * T[y * n + v];
+        gray[(y0 + y) * outW + x0 + x] = Math.max(0, Math.min(255, Math.round(s + 128)));
+      }
+    }
+    return { gray, width: outW, height: outH };
+  }
+
+  return { width, height, render };
+}
+
+module.exports = { open };
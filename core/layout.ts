@@ -0,0 +1,60 @@
+/**
+ * GitZipQR — Output directory layout
+ * Flat by default: every image directly in the output directory. With
+ * QR_SHARD_FANOUT=F the images go into QR_SHARD_DEPTH (default 2) levels of
+ * numbered directories, at most F files or subdirectories per directory:
+ *   F=1000, depth 2:  image 123456 -> 000/123/qr-123456.png
+ * Past F^(depth+1) images the top level takes the overflow (1000/000/...) rather
+ * than wrapping around, so no lower directory ever holds more than F entries.
+ * The decoder does not need to know the layout. It walks nested directories
+ * with fs.opendir and streams entries to the pool as they are listed, so no
+ * directory is read in full and no entry is stat'ed.
+ */
+const fs = require('fs');
+const path = require('path');
+
+const FANOUT = Math.max(0, parseInt(process.env.QR_SHARD_FANOUT || '0', 10));
+const DEPTH = Math.min(6, Math.max(1, parseInt(process.env.QR_SHARD_DEPTH || '2', 10)));
+
+/** Directory (under root) for image number i; root itself when sharding is off. */
+function shardDir(root, i, fanout = FANOUT, depth = DEPTH) {
+  if (fanout < 2) return root;
+  const width = String(fanout - 1).length, parts = [];
+  let n = Math.floor(i / fanout);
+  for (let level = 0; level < depth; level++, n = Math.floor(n / fanout)) parts.unshift(String(level === depth - 1 ? n : n % fanout).padStart(width, '0'));
+  return path.join(root, ...parts);
+}
+
+/** Creates shard directories once each; returns (i, name) -> output path. */
+function placer(root, fanout = FANOUT, depth = DEPTH) {
+  const made = new Set();
+  return (i, name) => {
+    const dir = shardDir(root, i, fanout, depth);
+    if (!made.has(dir)) { fs.mkdirSync(dir, { recursive: true }); made.add(dir); }
+    return path.join(dir, name);
+  };
+}
+
+/** Path relative to root with '/' separators (as stored in gitzipqr.index). */
+function relative(root, file) {
+  return path.relative(root, file).split(path.sep).join('/');
+}
+
+/** Async generator over every file below dir (any depth); skip(rel) filters by relative path. */
+async function* walk(dir, skip = () => false, root = dir) {
+  const handle = await fs.promises.opendir(dir);
+  for await (const entry of handle) {
+    const abs = path.join(dir, entry.name);
+    if (entry.isDirectory()) yield* walk(abs, skip, root);
+    else if (entry.isFile() && !skip(relative(root, abs))) yield abs;
+  }
+}
+
+/** Relative paths of every file below dir. */
+async function list(dir, skip) {
+  const out = [];
+  for await (const abs of walk(dir, skip)) out.push(relative(dir, abs));
+  return out;
+}
+
+module.exports = { FANOUT, DEPTH, shardDir, placer, relative, walk, list };
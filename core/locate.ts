@@ -0,0 +1,201 @@
+/**
+ * GitZipQR — QR locator for high-resolution scans
+ * Large inputs (a 24 MP scan of one symbol) are not handed to jsQR whole:
+ *   1. luma (or one color channel) -> gray, then a 2x box-filter pyramid;
+ *   2. finder patterns (1:1:3:1:1 runs, cross-checked vertically) are searched
+ *      from the coarsest level down until three consistent ones are found and
+ *      confirmed around the same spots one level finer;
+ *   3. the symbol's bounding box is cropped from the level where a module is
+ *      still >= QR_MIN_MODULE px and only that region is decoded.
+ * Thresholding (finder search and the images handed to jsQR) is the adaptive
+ * WASM SIMD kernel in shared/binarize.js; a binarized view is tried first and
+ * decoded without jsQR's inverted second pass.
+ * Falls back to the full-resolution crop, then to the whole image, so a miss
+ * in the locator never loses a symbol. Images up to QR_DETECT_MAX px go
+ * straight to the decoder as before.
+ */
+const DETECT_MAX = Math.max(256, parseInt(process.env.QR_DETECT_MAX || '1600', 10)); // px, longest side
+const MIN_MODULE = Math.max(1, parseFloat(process.env.QR_MIN_MODULE || '3')); // px per module after downscaling
+const binarize = require('../shared/binarize');
+const arena = require('./arena');
+
+const kernel = binarize.create();
+
+/** ch < 0: Rec. 601 luma; 0..2: that channel of the RGBA image. Gray images ({ gray }) pass through. */
+function toGray({ data, gray: g, width, height }, ch) {
+  if (g) return g;
+  if (ch < 0) return kernel.luma(data, width * height);
+  const gray = new Uint8Array(width * height);
+  for (let i = 0, j = ch; i < gray.length; i++, j += 4) gray[i] = data[j];
+  return gray;
+}
+
+// jsQR input; one view is consumed before the next is built, so they share a slot.
+function toRGBA(gray, width, height) {
+  const out = arena.typed('rgba', Uint8ClampedArray, width * height * 4);
+  for (let i = 0, j = 0; i < gray.length; i++, j += 4) { out[j] = out[j + 1] = out[j + 2] = gray[i]; out[j + 3] = 255; }
+  return { data: out, width, height };
+}
+
+function half({ gray, width, height }) {
+  const w = width >> 1, h = height >> 1, out = new Uint8Array(w * h);
+  for (let y = 0; y < h; y++) {
+    const r0 = 2 * y * width, r1 = r0 + width;
+    for (let x = 0; x < w; x++) out[y * w + x] = (gray[r0 + 2 * x] + gray[r0 + 2 * x + 1] + gray[r1 + 2 * x] + gray[r1 + 2 * x + 1] + 2) >> 2;
+  }
+  return { gray: out, width: w, height: h };
+}
+
+/** levels[0] is full resolution; the last one has its longest side <= DETECT_MAX / 2. */
+function pyramid(gray, width, height) {
+  const levels = [{ gray, width, height }];
+  while (Math.max(levels[levels.length - 1].width, levels[levels.length - 1].height) > DETECT_MAX / 2) levels.push(half(levels[levels.length - 1]));
+  return levels;
+}
+
+// Run lengths dark, light, dark, light, dark in proportion 1:1:3:1:1.
+function isFinder(s) {
+  const total = s[0] + s[1] + s[2] + s[3] + s[4];
+  if (total < 7 || !s[0] || !s[1] || !s[3] || !s[4]) return 0;
+  const unit = total / 7, tol = unit / 2;
+  return Math.abs(s[0] - unit) < tol && Math.abs(s[1] - unit) < tol && Math.abs(s[2] - 3 * unit) < 3 * tol
+    && Math.abs(s[3] - unit) < tol && Math.abs(s[4] - unit) < tol ? unit : 0;
+}
+
+// Vertical cross-check through (x, y); returns the refined center row or -1.
+function crossCheck(dark, width, height, x, y, span) {
+  const s = [0, 0, 0, 0, 0], at = (i) => dark[i * width + x];
+  let i = y;
+  while (i >= 0 && at(i)) { s[2]++; i--; }
+  while (i >= 0 && !at(i) && s[1] <= span) { s[1]++; i--; }
+  while (i >= 0 && at(i) && s[0] <= span) { s[0]++; i--; }
+  i = y + 1;
+  while (i < height && at(i)) { s[2]++; i++; }
+  while (i < height && !at(i) && s[3] <= span) { s[3]++; i++; }
+  while (i < height && at(i) && s[4] <= span) { s[4]++; i++; }
+  return isFinder(s) ? i - s[4] - s[3] - s[2] / 2 : -1;
+}
+
+/** Finder pattern centers in one gray image: [{ x, y, unit, hits }]; module is the expected unit, if known. */
+function finders({ gray, width, height }, module = 0) {
+  const dark = kernel.threshold(gray, width, height, { radius: binarize.radiusFor(module, width, height) });
+  for (let i = 0; i < dark.length; i++) dark[i] = dark[i] ? 0 : 1;
+  const found = [];
+  const add = (x, y, unit) => {
+    const near = found.find(f => Math.abs(f.x - x) < 3 * f.unit && Math.abs(f.y - y) < 3 * f.unit);
+    if (!near) { found.push({ x, y, unit, hits: 1 }); return; }
+    const n = near.hits++;
+    near.x = (near.x * n + x) / (n + 1); near.y = (near.y * n + y) / (n + 1); near.unit = (near.unit * n + unit) / (n + 1);
+  };
+  const s = [0, 0, 0, 0, 0];
+  for (let y = 0; y < height; y++) {
+    const row = y * width;
+    s.fill(0);
+    let k = 0; // run being counted: even = dark, odd = light
+    for (let x = 0; x < width; x++) {
+      if (dark[row + x]) {
+        if (k & 1) k++;
+        s[k]++;
+      } else if (k & 1) {
+        s[k]++;
+      } else if (k < 4) {
+        s[++k]++;
+      } else {
+        const unit = isFinder(s);
+        if (unit) {
+          const cx = Math.round(x - s[4] - s[3] - s[2] / 2);
+          const cy = crossCheck(dark, width, height, cx, y, 3 * (s[0] + s[1] + s[2] + s[3] + s[4]));
+          if (cy >= 0) add(cx, cy, unit);
+        }
+        s[0] = s[2]; s[1] = s[3]; s[2] = s[4]; s[3] = 1; s[4] = 0; k = 3; // keep the last dark/light/dark
+      }
+    }
+  }
+  return found;
+}
+
+// Triples of finders that look like the three corners of one symbol, best first.
+function triples(found) {
+  const top = found.sort((a, b) => b.hits - a.hits).slice(0, 8);
+  const out = [];
+  for (let i = 0; i < top.length; i++) for (let j = i + 1; j < top.length; j++) for (let k = j + 1; k < top.length; k++) {
+    const p = [top[i], top[j], top[k]];
+    const units = p.map(f => f.unit);
+    if (Math.max(...units) > 1.6 * Math.min(...units)) continue;
+    const d = (a, b) => Math.hypot(a.x - b.x, a.y - b.y);
+    const sides = [d(p[1], p[2]), d(p[0], p[2]), d(p[0], p[1])]; // side opposite p[n]
+    const corner = sides.indexOf(Math.max(...sides));
+    const legs = sides.filter((_, n) => n !== corner);
+    if (legs[0] / legs[1] < 0.6 || legs[0] / legs[1] > 1.67 || Math.min(...legs) < 10 * Math.min(...units)) continue;
+    out.push({ score: p.reduce((n, f) => n + f.hits, 0), corner: p[corner], others: p.filter((_, n) => n !== corner) });
+  }
+  return out.sort((a, b) => b.score - a.score);
+}
+
+// Coarse levels alias data modules into finder-like runs: a triple counts only if
+// each of its finders is found again in a small window of the next finer level,
+// on at least 2 modules' worth of rows (a real 3x3 core gives ~3, a chance 1:1:3:1:1 ~1).
+function confirm(level, { corner, others }) {
+  return [corner, ...others].every((f) => {
+    const unit = 2 * f.unit, cx = 2 * f.x, cy = 2 * f.y, half = 7 * unit;
+    const box = { x0: Math.max(0, Math.floor(cx - half)), y0: Math.max(0, Math.floor(cy - half)), x1: Math.ceil(cx + half), y1: Math.ceil(cy + half) };
+    const win = crop(level, 1, box);
+    return finders(win, unit).some(g => Math.hypot(g.x + box.x0 - cx, g.y + box.y0 - cy) < 2 * unit && g.unit < 1.5 * unit && g.unit > unit / 1.5 && g.hits >= 2 * g.unit);
+  });
+}
+
+/** Symbol bounding box at full resolution plus module size in px, or null. */
+function locate(levels) {
+  for (let l = levels.length - 1; l >= 1; l--) {
+    const triple = triples(finders(levels[l])).slice(0, 4).find(t => confirm(levels[l - 1], t));
+    if (!triple) continue;
+    const { corner: b, others: [a, c] } = triple;
+    const pts = [a, b, c, { x: a.x + c.x - b.x, y: a.y + c.y - b.y }];
+    const unit = (a.unit + b.unit + c.unit) / 3, pad = 9 * unit, f = 1 << l;
+    const { width, height } = levels[0];
+    const x0 = Math.max(0, Math.floor((Math.min(...pts.map(p => p.x)) - pad) * f));
+    const y0 = Math.max(0, Math.floor((Math.min(...pts.map(p => p.y)) - pad) * f));
+    const x1 = Math.min(width, Math.ceil((Math.max(...pts.map(p => p.x)) + pad) * f));
+    const y1 = Math.min(height, Math.ceil((Math.max(...pts.map(p => p.y)) + pad) * f));
+    return { x0, y0, x1, y1, module: unit * f };
+  }
+  return null;
+}
+
+function crop(level, f, box) {
+  const x0 = Math.min(level.width - 1, Math.floor(box.x0 / f)), y0 = Math.min(level.height - 1, Math.floor(box.y0 / f));
+  const w = Math.min(level.width, Math.ceil(box.x1 / f)) - x0, h = Math.min(level.height, Math.ceil(box.y1 / f)) - y0;
+  const out = new Uint8Array(w * h);
+  for (let y = 0; y < h; y++) out.set(level.gray.subarray((y0 + y) * level.width + x0, (y0 + y) * level.width + x0 + w), y * w);
+  return { gray: out, width: w, height: h };
+}
+
+// 0/255 image for jsQR; `binary` lets the reader skip the inverted pass.
+function binarized({ gray, width, height }, module) {
+  const bin = kernel.threshold(gray, width, height, { radius: binarize.radiusFor(module, width, height) });
+  return { ...toRGBA(bin, width, height), binary: true };
+}
+
+/**
+ * Images to try, cheapest first, for one symbol in `rgba` (ch as in toGray;
+ * `rgba` may also be a gray image from core/jpeg.ts).
+ * Each entry is a thunk returning { data: Uint8ClampedArray, width, height, binary? }.
+ */
+function views(rgba, ch = -1) {
+  const { data, width, height } = rgba;
+  const gray = toGray(rgba, ch);
+  const whole = rgba.gray || ch >= 0 ? () => toRGBA(gray, width, height)
+    : () => ({ data: new Uint8ClampedArray(data.buffer, data.byteOffset, data.byteLength), width, height });
+  if (Math.max(width, height) <= DETECT_MAX) return [() => binarized({ gray, width, height }, 0), whole];
+  const levels = pyramid(gray, width, height);
+  const box = locate(levels);
+  if (!box) return [whole];
+  let l = 0;
+  while (l + 1 < levels.length && box.module / (2 << l) >= MIN_MODULE) l++;
+  const out = [() => binarized(crop(levels[l], 1 << l, box), box.module / (1 << l))];
+  out.push(() => { const c = crop(levels[0], 1, box); return toRGBA(c.gray, c.width, c.height); });
+  out.push(whole);
+  return out;
+}
+
+module.exports = { DETECT_MAX, views, toGray, pyramid, finders, locate };
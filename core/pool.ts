@@ -0,0 +1,108 @@
+/**
+ * GitZipQR — Worker pool
+ * Keeps a fixed set of worker_threads alive and feeds them tasks over
+ * postMessage, so worker startup and module loading are paid once per pool
+ * instead of once per QR image.
+ *
+ * Protocol: the pool posts { id, task } and the worker answers { id, ...result }.
+ * `limit` (<= size) caps tasks in flight; core/resources.ts lowers it under
+ * memory pressure and raises it again afterwards.
+ */
+const path = require('path');
+const { Worker } = require('worker_threads');
+
+function workerPath(name) { return path.join(__dirname, name); }
+
+class WorkerPool {
+  constructor(script, size) {
+    this.script = script;
+    this.size = Math.max(1, size | 0);
+    this.limit = this.size;
+    this.workers = [];     // every live worker
+    this.idle = [];        // workers waiting for a task
+    this.queue = [];       // { task, transfer, resolve }
+    this.inflight = new Map(); // worker -> { id, resolve }
+    this.seq = 0;
+    this.closed = false;
+  }
+
+  get active() { return this.inflight.size; }
+  get pending() { return this.queue.length; }
+
+  /** Queue a task; resolves with the worker's reply (never rejects). */
+  run(task, transfer) {
+    if (this.closed) return Promise.resolve({ ok: false, error: 'pool is closed' });
+    return new Promise((resolve) => {
+      this.queue.push({ task, transfer, resolve });
+      this._pump();
+    });
+  }
+
+  _spawn() {
+    const w = new Worker(this.script);
+    w.on('message', (msg) => {
+      const job = this.inflight.get(w);
+      if (!job || !msg || msg.id !== job.id) return;
+      this.inflight.delete(w);
+      const { id, ...res } = msg;
+      job.resolve(res);
+      if (this.workers.length > this.limit) { this.workers = this.workers.filter(x => x !== w); w.terminate(); }
+      else this.idle.push(w);
+      this._pump();
+    });
+    const fail = (err) => {
+      const job = this.inflight.get(w);
+      this.inflight.delete(w);
+      this.workers = this.workers.filter(x => x !== w);
+      this.idle = this.idle.filter(x => x !== w);
+      if (job) job.resolve({ ok: false, error: String(err && err.message || err || 'worker exited') });
+      this._pump();
+    };
+    w.on('error', fail);
+    w.on('exit', (code) => { if (this.workers.includes(w)) fail(new Error(`worker exited ${code}`)); });
+    this.workers.push(w);
+    return w;
+  }
+
+  /** Cap concurrency at n (1..size); idle workers above the cap are terminated. */
+  setLimit(n) {
+    this.limit = Math.min(this.size, Math.max(1, n | 0));
+    while (this.workers.length > this.limit && this.idle.length) {
+      const w = this.idle.pop();
+      this.workers = this.workers.filter(x => x !== w);
+      w.terminate();
+    }
+    this._pump();
+  }
+
+  _pump() {
+    while (this.queue.length && !this.closed && this.inflight.size < this.limit) {
+      let w = this.idle.pop();
+      if (!w) {
+        if (this.workers.length >= this.limit) return;
+        w = this._spawn();
+      }
+      const { task, transfer, resolve } = this.queue.shift();
+      const id = ++this.seq;
+      this.inflight.set(w, { id, resolve });
+      w.postMessage({ id, task }, transfer || []);
+    }
+  }
+
+  /** Drop queued tasks that have not been handed to a worker yet. */
+  clear(reason = 'cancelled') {
+    const q = this.queue; this.queue = [];
+    for (const j of q) j.resolve({ ok: false, error: reason });
+  }
+
+  async destroy() {
+    this.closed = true;
+    this.clear('pool is closed');
+    const ws = this.workers; this.workers = []; this.idle = [];
+    for (const job of this.inflight.values()) job.resolve({ ok: false, error: 'pool is closed' });
+    this.inflight.clear();
+    await Promise.all(ws.map(w => w.terminate()));
+  }
+}
+
+module.exports = { WorkerPool, workerPath };
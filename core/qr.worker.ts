@@ -1,45 +1,27 @@
 /**
  * QR Encode Worker
- * - Prefers native 'qrencode' binary if available (faster).
- * - Falls back to 'qrcode' JS library.
+ * - Renders one image per task with the backend named in task.symbology
+ *   (default "qr": native 'qrencode' if available, else the 'qrcode' JS library;
+ *   see core/symbology.ts for the others).
+ * - Color mode: up to three symbols drawn into the R, G and B channels of one PNG.
+ * - hashImage: replies with the SHA-256 of the written file (for the chunk index).
+ * - Persistent: serves { id, task } messages from core/pool.ts until terminated.
  */
-const { parentPort, workerData } = require('worker_threads');
-const { spawn } = require('child_process');
+const fs = require('fs');
+const crypto = require('crypto');
+const { parentPort } = require('worker_threads');
+const symbology = require('./symbology');
 
-async function encodeWithQrencode(outPath, text, ecl, margin) {
-  return new Promise((resolve, reject) => {
-    const args = ['-o', outPath, '-l', ecl || 'Q', '-m', String(margin ?? 1), '-t', 'PNG'];
-    const p = spawn('qrencode', args, { stdio: ['pipe', 'ignore', 'pipe'] });
-    let stderr = '';
-    p.stderr.on('data', d => (stderr += d.toString()));
-    p.on('close', code => {
-      if (code === 0) resolve(true);
-      else reject(new Error(stderr || `qrencode exited ${code}`));
-    });
-    p.stdin.end(text, 'utf8');
-  });
-}
-
-async function encodeWithJs(outPath, text, ecl, margin) {
-  const qrcode = require('qrcode');
-  return new Promise((resolve, reject) => {
-    qrcode.toFile(outPath, text, { errorCorrectionLevel: ecl || 'Q', margin: margin ?? 1 }, err => {
-      if (err) reject(err);
-      else resolve(true);
-    });
-  });
-}
-
-(async () => {
-  const { outPath, text, useQrencode, ecl, margin } = workerData;
+async function handle(task) {
   try {
-    if (useQrencode) {
-      await encodeWithQrencode(outPath, text, ecl, margin);
-    } else {
-      await encodeWithJs(outPath, text, ecl, margin);
-    }
-    parentPort.postMessage({ ok: true });
+    await symbology.get(task.symbology).render(task);
+    if (!task.hashImage) return { ok: true };
+    return { ok: true, sha256: crypto.createHash('sha256').update(fs.readFileSync(task.outPath)).digest('hex') };
   } catch (e) {
-    parentPort.postMessage({ ok: false, error: String(e && e.message || e) });
+    return { ok: false, error: String(e && e.message || e) };
   }
-})();
+}
+
+parentPort.on('message', async ({ id, task }) => {
+  parentPort.postMessage({ id, ...(await handle(task)) });
+});
@@ -1,21 +1,54 @@
 /**
  * QR Decode Worker
- * - Reads PNG/JPEG, decodes with jsQR and returns parsed JSON.
+ * - Reads PNG/JPEG (a file path, or PNG bytes such as APNG frames), finds the
+ *   symbols with core/symbology.ts (grid or QR via jsQR) and returns the chunk
+ *   { meta, data } for JSON text payloads and binary GZQR frames alike.
+ * - Baseline JPEGs go through core/jpeg.ts: luma only, IDCT-scaled down to about
+ *   QR_DETECT_MAX px (full size is retried on a miss); others use jpeg-js.
+ * - File bytes, gray planes, JPEG coefficients and jsQR's RGBA input live in
+ *   reused per-worker buffers (core/arena.ts); gray-looking PNGs skip pngjs.
+ * - Color images whose channels hold separate symbols (QR_COLOR=rgb) carry up
+ *   to three; luma is read first, then each channel, and the reply lists them in `items`.
+ * - task.sha256 (from the chunk index) is checked against the file bytes before
+ *   any pixel work; a mismatch fails the image with `corrupt: true`.
+ * - Persistent: serves { id, task } messages from core/pool.ts until terminated.
  */
-const { parentPort, workerData } = require('worker_threads');
-const fs = require('fs');
+const crypto = require('crypto');
+const { parentPort } = require('worker_threads');
 const { PNG } = require('pngjs');
 const jpeg = require('jpeg-js');
-const jsQR = require('jsqr');
+const { parsePayload } = require('../shared/frame');
+const symbology = require('./symbology');
+const { DETECT_MAX } = require('./locate');
+const scaledJpeg = require('./jpeg');
+const { decodePngGray } = require('./apng');
+const arena = require('./arena');
 
-function readRGBA(filePath) {
-  const buf = fs.readFileSync(filePath);
+// Largest IDCT reduction (n/8) that keeps the longest side >= QR_DETECT_MAX.
+function jpegScale(width, height) {
+  let n = 8;
+  while (n > 1 && Math.max(width, height) * n / 16 >= DETECT_MAX) n /= 2;
+  return n;
+}
+
+// { data: RGBA, width, height } or, from the scaled JPEG path, { gray, width, height, full }.
+function readImage(src, sha256) {
+  const buf = typeof src === 'string' ? arena.readFile(src) : Buffer.from(src.buffer, src.byteOffset, src.byteLength);
+  if (sha256 && crypto.createHash('sha256').update(buf).digest('hex') !== sha256) {
+    throw Object.assign(new Error('image hash mismatch'), { corrupt: true });
+  }
   const isPng = buf.slice(0,8).equals(Buffer.from('89504e470d0a1a0a','hex'));
   const isJpeg = buf[0] === 0xff && buf[1] === 0xd8;
   if (isPng) {
-    const png = PNG.sync.read(buf);
+    const gray = decodePngGray(buf, (n) => arena.take('gray', n));
+    if (gray) return gray;
+    const png = PNG.sync.read(buf); // color (RGB mode), 16-bit, interlaced
     return { data: png.data, width: png.width, height: png.height };
   } else if (isJpeg) {
+    try {
+      const j = scaledJpeg.open(buf, arena.typed), n = jpegScale(j.width, j.height);
+      return { ...j.render(n), full: n < 8 ? () => j.render(8) : null };
+    } catch {} // progressive, CMYK, ...: fall back to jpeg-js
     const raw = jpeg.decode(buf, { useTArray: true });
     return { data: raw.data, width: raw.width, height: raw.height };
   } else {
@@ -23,16 +56,21 @@ function readRGBA(filePath) {
   }
 }
 
-try {
-  const { img } = workerData;
-  const { data, width, height } = readRGBA(img);
-  const u8 = new Uint8ClampedArray(data.buffer, data.byteOffset, data.byteLength);
-  const result = jsQR(u8, width, height);
-  if (!result || !result.data) throw new Error('QR not detected');
-  let payload;
-  try { payload = JSON.parse(result.data); }
-  catch { throw new Error('QR payload is not valid JSON'); }
-  parentPort.postMessage({ ok: true, payload });
-} catch (e) {
-  parentPort.postMessage({ ok: false, error: String(e && e.message || e) });
+function handle(task) {
+  try {
+    const { img, sha256 } = task;
+    const image = readImage(img, sha256);
+    let symbols = symbology.read(image);
+    if (!symbols.length && image.full) symbols = symbology.read(image.full());
+    if (!symbols.length) throw new Error('QR not detected');
+    const items = symbols.map(s => parsePayload(s.text, s.bytes)).filter(Boolean).map(p => ({ meta: p.meta, data: p.data }));
+    if (!items.length) throw new Error('QR payload is not a GitZipQR chunk');
+    return items.length === 1 ? { ok: true, ...items[0] } : { ok: true, items };
+  } catch (e) {
+    return { ok: false, error: String(e && e.message || e), ...(e && e.corrupt ? { corrupt: true } : {}) };
+  }
 }
+
+parentPort.on('message', ({ id, task }) => {
+  parentPort.postMessage({ id, ...handle(task) });
+});
@@ -0,0 +1,133 @@
+/**
+ * GitZipQR — Resource planner
+ * Sizes worker pools and scrypt to the container rather than the host:
+ *   - CPUs: cgroup v2 cpu.max (v1 cfs quota/period), sched affinity, os.cpus();
+ *   - memory: cgroup v2 memory.max (v1 limit_in_bytes) walked up the hierarchy, os.totalmem().
+ * Pools get min(CPUs, memory budget / per-worker estimate) workers and are then
+ * governed at run time: when RSS nears the limit, dispatch is throttled and idle
+ * workers are retired, and concurrency grows back once memory is released.
+ *
+ * QR_WORKERS pins the pool size; QR_WORKER_MEM (MiB) overrides the per-worker
+ * estimate; QR_MEM_HEADROOM (default 0.8) is the share of the limit we plan for.
+ */
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const MiB = 1024 * 1024;
+const HEADROOM = Math.min(0.95, Math.max(0.2, parseFloat(process.env.QR_MEM_HEADROOM || '0.8')));
+// Peak per worker: V8 isolate + file + pixel planes + jsQR matrices for a ~1000 px image.
+const WORKER_MEM = { encode: 64 * MiB, decode: 96 * MiB };
+const CGROUP_ROOT = '/sys/fs/cgroup';
+
+function readText(file) {
+  try { return fs.readFileSync(file, 'utf8').trim(); } catch { return null; }
+}
+
+// This process's cgroup v2 directory and its ancestors, innermost first.
+function cgroupDirs() {
+  const dirs = [];
+  const line = (readText('/proc/self/cgroup') || '').split('\n').find(l => l.startsWith('0::'));
+  let dir = line ? path.join(CGROUP_ROOT, line.slice(3)) : CGROUP_ROOT;
+  while (dir.startsWith(CGROUP_ROOT)) {
+    dirs.push(dir);
+    if (dir === CGROUP_ROOT) break;
+    dir = path.dirname(dir);
+  }
+  return dirs;
+}
+
+/** CPU quota in cores (e.g. 1.5), or null if unlimited. */
+function cpuQuota() {
+  let quota = null;
+  for (const dir of cgroupDirs()) {
+    const v = readText(path.join(dir, 'cpu.max'));
+    if (!v) continue;
+    const [max, period] = v.split(/\s+/);
+    if (max !== 'max') quota = Math.min(quota ?? Infinity, Number(max) / Number(period || 100000));
+  }
+  if (quota != null) return quota;
+  for (const dir of ['cpu', 'cpu,cpuacct']) {
+    const q = Number(readText(path.join(CGROUP_ROOT, dir, 'cpu.cfs_quota_us')));
+    const p = Number(readText(path.join(CGROUP_ROOT, dir, 'cpu.cfs_period_us')) || 100000);
+    if (q > 0) return q / p;
+  }
+  return null;
+}
+
+/** Memory limit in bytes and where it came from. */
+function memoryLimit() {
+  let limit = null;
+  for (const dir of cgroupDirs()) {
+    const v = readText(path.join(dir, 'memory.max'));
+    if (v && v !== 'max') limit = Math.min(limit ?? Infinity, Number(v));
+  }
+  if (limit == null) {
+    const v1 = Number(readText(path.join(CGROUP_ROOT, 'memory', 'memory.limit_in_bytes')));
+    if (v1 > 0 && v1 < 2 ** 60) limit = v1;
+  }
+  const total = os.totalmem();
+  return limit != null && limit < total ? { bytes: limit, source: 'cgroup' } : { bytes: total, source: 'host' };
+}
+
+function cpuCount() {
+  const host = typeof os.availableParallelism === 'function' ? os.availableParallelism() : os.cpus().length;
+  const quota = cpuQuota();
+  return quota == null ? { count: host, source: 'host' } : { count: Math.max(1, Math.min(host, Math.floor(quota))), source: 'cgroup' };
+}
+
+/** Bytes crypto.scrypt allocates (OpenSSL: V = 128 r (N + 2), B = 128 r p). */
+function scryptMemory({ N, r, p }) {
+  return 128 * r * (N + 2) + 128 * r * p;
+}
+
+/**
+ * Plan for one process: { cpus, memory, workers, scryptP, reserve }.
+ * kind: 'encode' | 'decode' | 'daemon' (both pools); kdf: scrypt params held alongside the pools.
+ */
+function plan(kind = 'decode', kdf = { N: 1 << 15, r: 8, p: 1 }) {
+  const cpus = cpuCount(), memory = memoryLimit();
+  const perWorker = process.env.QR_WORKER_MEM ? parseFloat(process.env.QR_WORKER_MEM) * MiB
+    : kind === 'daemon' ? WORKER_MEM.encode + WORKER_MEM.decode : WORKER_MEM[kind];
+  const reserve = scryptMemory(kdf) + process.memoryUsage().rss;
+  const budget = memory.bytes * HEADROOM - reserve;
+  const fit = Math.max(1, Math.min(cpus.count, Math.floor(budget / perWorker)));
+  const workers = process.env.QR_WORKERS ? Math.max(1, parseInt(process.env.QR_WORKERS, 10)) : fit;
+  return { cpus, memory, workers, scryptP: cpus.count, reserve };
+}
+
+/** scrypt options sized to the request; throws up front instead of being OOM-killed. */
+function scryptOptions(kdf) {
+  const need = scryptMemory(kdf), { bytes, source } = memoryLimit();
+  if (need > bytes * HEADROOM) {
+    throw new Error(`scrypt N=${kdf.N} r=${kdf.r} needs ${Math.ceil(need / MiB)} MiB, over the ${source} memory limit of ${Math.floor(bytes / MiB)} MiB`);
+  }
+  return { N: kdf.N, r: kdf.r, p: kdf.p, maxmem: need + 16 * MiB };
+}
+
+function describe({ cpus, memory, workers }) {
+  return `cpus=${cpus.count} (${cpus.source}), memory=${Math.floor(memory.bytes / MiB)} MiB (${memory.source}), workers=${workers}`;
+}
+
+/* ---- run-time governor ---- */
+const governed = new Set();
+let timer = null;
+
+function tick() {
+  const limit = memoryLimit().bytes, rss = process.memoryUsage().rss;
+  for (const pool of governed) {
+    if (pool.closed) { governed.delete(pool); continue; }
+    if (rss > limit * HEADROOM) pool.setLimit(Math.max(1, Math.floor(pool.limit / 2)));
+    else if (rss < limit * HEADROOM * 0.7 && pool.limit < pool.size) pool.setLimit(pool.limit + 1);
+  }
+  if (!governed.size) { clearInterval(timer); timer = null; }
+}
+
+/** Watches process RSS against the memory limit and adjusts pool.limit. */
+function govern(pool) {
+  governed.add(pool);
+  if (!timer) { timer = setInterval(tick, 250); timer.unref(); }
+  return pool;
+}
+
+module.exports = { plan, describe, scryptOptions, scryptMemory, govern, cpuCount, memoryLimit };
@@ -0,0 +1,128 @@
+/**
+ * GitZipQR — Multi-host shards
+ * `--shard i/n` (0 <= i < n) splits one encode or decode over n processes or hosts.
+ *
+ * Encode: every shard zips, encrypts and hashes the whole input, then renders
+ * only its contiguous range of chunks (or fountain seeds). All shards must
+ * produce the same ciphertext. A directory input is therefore zipped by
+ * core/zip.ts (sorted entries, fixed times and modes, store-only) instead of
+ * archiver, so equal trees give equal plaintext. The operator also generates
+ * one random shard seed per encode and passes it to every host
+ * (`--shard-seed <hex>` or QR_SHARD_SEED). The salt is an HMAC of the seed. The nonce is an HMAC of the
+ * seed and the data's SHA-256, so reusing a seed for other data still gets a
+ * fresh nonce. Without the seed, the published salt and nonce say nothing
+ * about the data. SCRYPT_p must be set explicitly, since its default follows
+ * the local CPU count. The fileId identifies the ciphertext, so shards that saw
+ * different input cannot be mixed up.
+ *
+ * Decode: each shard reads the images whose relative path hashes to it, with no
+ * password. It checks every chunk it holds completely, then writes its symbols
+ * to `<fileId>.<i>-of-<n>.gzqpart`: a JSON header line followed by the raw
+ * symbol bytes. A shard that owns no chunk images writes `empty.<i>-of-<n>.gzqpart`
+ * (fileId null, no records), so the set stays complete. `decode <parts> --merge`
+ * loads all n part files, assembles and checks the chunks and the archive hash,
+ * and decrypts.
+ */
+const fs = require('fs');
+const path = require('path');
+
+const PART_TYPE = 'GitZipQR-PART';
+const PART_EXT = '.gzqpart';
+const VERSION = 1;
+
+/** "i/n" -> { i, n }. */
+function parse(spec) {
+  const m = /^(\d+)\/(\d+)$/.exec(String(spec || ''));
+  const i = m ? +m[1] : NaN, n = m ? +m[2] : NaN;
+  if (!(n >= 1 && i >= 0 && i < n)) throw new Error(`--shard expects i/n with 0 <= i < n, got ${spec}`);
+  return { i, n };
+}
+
+/** Reads `--shard i/n` from argv; null when absent. */
+function fromArgv(argv) {
+  const k = argv.indexOf('--shard');
+  return k < 0 ? null : parse(argv[k + 1]);
+}
+
+/**
+ * Shared shard seed from `--shard-seed <hex>` or QR_SHARD_SEED, as bytes; null when absent.
+ * At least 128 bits, e.g. `openssl rand -hex 32`.
+ */
+function seedFromArgv(argv, env = process.env) {
+  const k = argv.indexOf('--shard-seed');
+  const hex = k >= 0 ? argv[k + 1] : env.QR_SHARD_SEED;
+  if (hex == null || hex === '') return null;
+  if (!/^([0-9a-f]{2}){16,}$/i.test(hex)) throw new Error('--shard-seed expects at least 32 hex digits (e.g. openssl rand -hex 32)');
+  return Buffer.from(hex, 'hex');
+}
+
+/** Contiguous share [from, to) of `total` items for a shard. */
+function range(total, { i, n }) {
+  return [Math.floor(i * total / n), Math.floor((i + 1) * total / n)];
+}
+
+/** Whether an image (path relative to the decoded directory) belongs to a shard: FNV-1a of the path. */
+function owns(rel, { i, n }) {
+  let h = 0x811c9dc5;
+  for (let k = 0; k < rel.length; k++) h = Math.imul(h ^ rel.charCodeAt(k), 0x01000193);
+  return (h >>> 0) % n === i;
+}
+
+/**
+ * header: { fileId, shard, total, meta, verified }; records: [{ chunk, part, partTotal, hash, data }].
+ * fileId is null for an empty part. Returns the path of the part file.
+ */
+function writePart(dir, header, records) {
+  const head = {
+    type: PART_TYPE, version: VERSION, ...header,
+    records: records.map(r => [r.chunk, r.part, r.partTotal, r.data.length, r.hash || null]),
+  };
+  const file = path.join(dir, `${header.fileId || 'empty'}.${header.shard.i}-of-${header.shard.n}${PART_EXT}`);
+  const tmp = file + '.tmp';
+  fs.writeFileSync(tmp, Buffer.concat([Buffer.from(JSON.stringify(head) + '\n'), ...records.map(r => r.data)]));
+  fs.renameSync(tmp, file);
+  return file;
+}
+
+function readPart(file) {
+  const buf = fs.readFileSync(file);
+  const nl = buf.indexOf(10);
+  const header = nl > 0 ? JSON.parse(buf.subarray(0, nl).toString('utf8')) : null;
+  if (!header || header.type !== PART_TYPE) throw new Error(`${file} is not a GitZipQR part file`);
+  if (header.version !== VERSION) throw new Error(`Unsupported part file version ${header.version}`);
+  let off = nl + 1;
+  const records = header.records.map(([chunk, part, partTotal, length, hash]) => {
+    const data = buf.subarray(off, off + length);
+    off += length;
+    return { chunk, part, partTotal, hash, data };
+  });
+  if (off !== buf.length) throw new Error(`${file} is truncated or has trailing data`);
+  return { header, records };
+}
+
+/**
+ * Part files of one archive from a file or directory. Checks that they share a
+ * fileId (empty parts have none) and shard count and that every shard is there
+ * exactly once.
+ */
+function readParts(input) {
+  const files = fs.statSync(input).isDirectory()
+    ? fs.readdirSync(input).filter(f => f.endsWith(PART_EXT)).sort().map(f => path.join(input, f))
+    : [input];
+  if (!files.length) throw new Error(`No *${PART_EXT} files in ${input}`);
+  const parts = files.map(readPart);
+  const { n } = parts[0].header.shard;
+  const fileId = (parts.find(p => p.header.fileId) || parts[0]).header.fileId;
+  const seen = new Set();
+  for (const { header } of parts) {
+    if (header.fileId && header.fileId !== fileId) throw new Error(`Part files belong to different archives (${fileId}, ${header.fileId})`);
+    if (header.shard.n !== n) throw new Error(`Part files were decoded with different shard counts (${n}, ${header.shard.n})`);
+    if (seen.has(header.shard.i)) throw new Error(`Shard ${header.shard.i}/${n} is present twice`);
+    seen.add(header.shard.i);
+  }
+  const absent = Array.from({ length: n }, (_, i) => i).filter(i => !seen.has(i));
+  if (absent.length) throw new Error(`Missing part files for shard(s) ${absent.map(i => `${i}/${n}`).join(', ')}`);
+  return parts;
+}
+
+module.exports = { PART_EXT, parse, fromArgv, seedFromArgv, range, owns, writePart, readPart, readParts };
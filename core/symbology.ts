@@ -0,0 +1,169 @@
+/**
+ * GitZipQR — Symbology backends
+ * One payload (string or bytes) <-> one image. Workers dispatch on the backend
+ * name carried by each task, and the encoder records a non-default backend in
+ * the chunk metadata (`sym`), so denser codes can sit alongside QR:
+ *
+ *   qr    QR code (qrencode or qrcode; jsQR to read, after core/locate.ts crops large
+ *         scans). ~2.9 KB per symbol at v40-L.
+ *         `channels` tasks draw up to three symbols into the R/G/B planes of one image.
+ *   grid  Lossless 8-bit grayscale cell grid for digital-only storage: one byte
+ *         per pixel, a "GZGR" header row with length and CRC-32. Not for print.
+ *
+ * Backend: { name, capacity({ version, ecl }), render(task) -> Promise, read(image) -> [{ text, bytes }] | null }
+ * where image is { data: RGBA, width, height } or { gray, width, height } (scaled JPEG path).
+ */
+const fs = require('fs');
+const { spawn } = require('child_process');
+const { byteCapacity } = require('../shared/capacity');
+const { encodeGrayPng, crc32 } = require('./apng');
+const locate = require('./locate');
+
+const GRID_SIZE = Math.max(64, parseInt(process.env.GRID_SIZE || '1024', 10)); // max grid width/height in cells
+const GRID_MAGIC = [0x47, 0x5a, 0x47, 0x52]; // "GZGR"
+
+/* ---- QR ---- */
+// `content` is a string (text payload) or a Uint8Array (binary frame, 8-bit mode).
+function encodeWithQrencode(outPath, content, ecl, margin) {
+  return new Promise((resolve, reject) => {
+    const args = ['-o', outPath, '-l', ecl || 'Q', '-m', String(margin ?? 1), '-t', 'PNG'];
+    if (typeof content !== 'string') args.push('-8');
+    const p = spawn('qrencode', args, { stdio: ['pipe', 'ignore', 'pipe'] });
+    let stderr = '';
+    p.stderr.on('data', d => (stderr += d.toString()));
+    p.on('close', code => {
+      if (code === 0) resolve(true);
+      else reject(new Error(stderr || `qrencode exited ${code}`));
+    });
+    if (typeof content === 'string') p.stdin.end(content, 'utf8');
+    else p.stdin.end(Buffer.from(content.buffer, content.byteOffset, content.byteLength));
+  });
+}
+
+function encodeWithJs(outPath, content, ecl, margin) {
+  const qrcode = require('qrcode');
+  const segments = typeof content === 'string' ? content : [{ data: content, mode: 'byte' }];
+  return new Promise((resolve, reject) => {
+    qrcode.toFile(outPath, segments, { errorCorrectionLevel: ecl || 'Q', margin: margin ?? 1 }, err => {
+      if (err) reject(err);
+      else resolve(true);
+    });
+  });
+}
+
+// Each channel holds one symbol (dark module = 0 in that channel); unused channels stay white.
+function encodeColor(outPath, contents, ecl, margin, scale = 4) {
+  const qrcode = require('qrcode');
+  const { PNG } = require('pngjs');
+  const symbols = contents.map(c => qrcode.create(typeof c === 'string' ? c : [{ data: c, mode: 'byte' }], { errorCorrectionLevel: ecl || 'Q' }).modules);
+  const m = margin ?? 1;
+  const px = (Math.max(...symbols.map(s => s.size)) + 2 * m) * scale;
+  const png = new PNG({ width: px, height: px });
+  png.data.fill(255);
+  symbols.forEach((sym, ch) => {
+    for (let r = 0; r < sym.size; r++) {
+      for (let c = 0; c < sym.size; c++) {
+        if (!sym.data[r * sym.size + c]) continue;
+        for (let y = (r + m) * scale; y < (r + m + 1) * scale; y++) {
+          for (let x = (c + m) * scale; x < (c + m + 1) * scale; x++) png.data[(y * px + x) * 4 + ch] = 0;
+        }
+      }
+    }
+  });
+  fs.writeFileSync(outPath, PNG.sync.write(png));
+}
+
+// Whether the channels look like separate symbols (encodeColor): at least 1/8 of
+// the sampled pixels have channels a full half-scale apart. JPEG noise and tinted
+// photos of a printed code stay far below that.
+function channelsSplit(data) {
+  let hits = 0, seen = 0;
+  for (let i = 0; i < data.length; i += 4 * 7, seen++) {
+    const r = data[i], g = data[i + 1], b = data[i + 2];
+    if (Math.max(r, g, b) - Math.min(r, g, b) > 128) hits++;
+  }
+  return hits * 8 >= seen && seen > 0;
+}
+
+function readQR({ data, width, height, binary }) {
+  const jsQR = require('jsqr');
+  const result = jsQR(data, width, height, { inversionAttempts: binary ? 'dontInvert' : 'attemptBoth' });
+  return result && result.data ? { text: result.data, bytes: Uint8Array.from(result.binaryData) } : null;
+}
+
+// One symbol (ch < 0: luma, else that channel): binarized and, on large scans, located views first (core/locate.ts).
+function scanQR(rgba, ch) {
+  for (const view of locate.views(rgba, ch)) {
+    const hit = readQR(view());
+    if (hit) return hit;
+  }
+  return null;
+}
+
+const qr = {
+  name: 'qr',
+  capacity: ({ version = 40, ecl = 'Q' } = {}) => byteCapacity(version, ecl),
+  async render({ outPath, text, data, channels, useQrencode, ecl, margin }) {
+    const content = data || text;
+    if (channels) encodeColor(outPath, channels, ecl, margin);
+    else if (useQrencode) await encodeWithQrencode(outPath, content, ecl, margin);
+    else await encodeWithJs(outPath, content, ecl, margin);
+  },
+  // Luma first; the three channels only when they really carry separate symbols.
+  read(rgba) {
+    const hit = scanQR(rgba, -1);
+    if (!rgba.data || !channelsSplit(rgba.data)) return hit ? [hit] : null;
+    const items = hit ? [hit] : [];
+    for (const ch of [0, 1, 2]) {
+      const h = scanQR(rgba, ch);
+      if (h && !items.some(x => x.text === h.text && Buffer.compare(x.bytes, h.bytes) === 0)) items.push(h);
+    }
+    return items.length ? items : null;
+  },
+};
+
+/* ---- Grid ---- */
+// Row 0: "GZGR" | version 1 | length u32 BE | CRC-32 u32 BE; payload bytes from row 1 on.
+const grid = {
+  name: 'grid',
+  capacity: () => GRID_SIZE * (GRID_SIZE - 1),
+  async render({ outPath, text, data }) {
+    const bytes = data || Buffer.from(text, 'utf8');
+    const width = GRID_SIZE, height = 1 + Math.max(1, Math.ceil(bytes.length / width));
+    if (height > GRID_SIZE) throw new Error(`grid payload too large: ${bytes.length} bytes`);
+    const gray = new Uint8Array(width * height);
+    const head = Buffer.alloc(13);
+    head.set(GRID_MAGIC, 0); head[4] = 1;
+    head.writeUInt32BE(bytes.length, 5); head.writeUInt32BE(crc32(bytes), 9);
+    gray.set(head, 0);
+    gray.set(bytes, width);
+    fs.writeFileSync(outPath, encodeGrayPng(width, height, gray, 1)); // ciphertext does not compress
+  },
+  read({ data, gray, width, height }) {
+    const at = gray ? (i) => gray[i] : (i) => data[i * 4]; // gray -> R of RGBA
+    if (width < 13 || !GRID_MAGIC.every((b, i) => at(i) === b) || at(4) !== 1) return null;
+    const len = ((at(5) << 24) | (at(6) << 16) | (at(7) << 8) | at(8)) >>> 0;
+    const crc = ((at(9) << 24) | (at(10) << 16) | (at(11) << 8) | at(12)) >>> 0;
+    if (len > width * (height - 1)) throw new Error('grid header is corrupt');
+    const bytes = new Uint8Array(len);
+    for (let i = 0; i < len; i++) bytes[i] = at(width + i);
+    if (crc32(bytes) !== crc) throw new Error('grid CRC mismatch');
+    const text = bytes[0] === 0x7b ? Buffer.from(bytes).toString('utf8') : ''; // JSON payloads start with "{"
+    return [{ text, bytes }];
+  },
+};
+
+const BACKENDS = { qr, grid };
+
+function get(name = 'qr') {
+  const b = BACKENDS[name];
+  if (!b) throw new Error(`Unknown symbology ${name} (available: ${Object.keys(BACKENDS).join(', ')})`);
+  return b;
+}
+
+/** Reads every symbol in an image; the cheap grid header check runs first. */
+function read(rgba) {
+  return grid.read(rgba) || qr.read(rgba) || [];
+}
+
+module.exports = { get, read, names: Object.keys(BACKENDS) };
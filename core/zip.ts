@@ -0,0 +1,105 @@
+/**
+ * GitZipQR — Canonical ZIP for sharded encodes
+ * `encode --shard` needs byte-identical plaintext on every host, which archiver
+ * does not give: entry order follows fs.readdir, modes follow the local umask and
+ * deflate output follows the local zlib. writeCanonical() writes a store-only
+ * ZIP instead. Entries are sorted by path, directories included. Every
+ * timestamp is 1980-01-01 00:00. Modes are 0644 or 0755 (executable bit kept),
+ * with no owner or extra fields. The same tree therefore gives the same bytes
+ * on any host. Symlinks and archives over 4 GiB or 65535 entries (ZIP64) are refused.
+ */
+const fs = require('fs');
+const path = require('path');
+const { crcUpdate } = require('./apng');
+
+const DOS_DATE = (1 << 5) | 1; // 1980-01-01
+const UTF8 = 0x0800;
+const LIMIT = 0xffffffff;
+const COPY = 1 << 20;
+
+/** [{ rel, abs, dir, mode }] below root in sorted order; rel uses '/' separators. */
+function entries(root, rel = '', out = []) {
+  const names = fs.readdirSync(path.join(root, rel)).sort();
+  for (const name of names) {
+    const r = rel ? `${rel}/${name}` : name, abs = path.join(root, r);
+    const st = fs.lstatSync(abs);
+    if (st.isDirectory()) {
+      out.push({ rel: r + '/', abs, dir: true, mode: 0o40755 });
+      entries(root, r, out);
+    } else if (st.isFile()) {
+      out.push({ rel: r, abs, dir: false, mode: st.mode & 0o111 ? 0o100755 : 0o100644 });
+    } else {
+      throw new Error(`${abs}: only regular files and directories can be sharded (zip it yourself and encode the archive)`);
+    }
+  }
+  return out;
+}
+
+// Shared fields of the local and central headers from "version needed" on.
+function common(crc, size, name) {
+  const b = Buffer.alloc(26);
+  b.writeUInt16LE(10, 0); // version needed: 1.0 (stored)
+  b.writeUInt16LE(UTF8, 2);
+  b.writeUInt16LE(0, 4); // method: stored
+  b.writeUInt16LE(0, 6); // time 00:00
+  b.writeUInt16LE(DOS_DATE, 8);
+  b.writeUInt32LE(crc, 10);
+  b.writeUInt32LE(size, 14);
+  b.writeUInt32LE(size, 18);
+  b.writeUInt16LE(name.length, 22);
+  b.writeUInt16LE(0, 24); // extra length
+  return b;
+}
+
+/** Writes the canonical ZIP of directory `dir` to outPath. */
+function writeCanonical(dir, outPath) {
+  const list = entries(dir);
+  if (list.length > 0xffff) throw new Error(`${dir} has ${list.length} entries; the canonical zip is limited to 65535`);
+  const fd = fs.openSync(outPath, 'w');
+  const central = [];
+  let offset = 0;
+  const put = (buf, at) => { fs.writeSync(fd, buf, 0, buf.length, at); };
+  try {
+    const chunk = Buffer.alloc(COPY);
+    for (const e of list) {
+      const name = Buffer.from(e.rel, 'utf8'), start = offset;
+      const sig = Buffer.alloc(4); sig.writeUInt32LE(0x04034b50, 0);
+      offset += 30 + name.length; // header written once crc and size are known
+      let crc = 0xffffffff, size = 0;
+      if (!e.dir) {
+        const src = fs.openSync(e.abs, 'r');
+        try {
+          for (let n; (n = fs.readSync(src, chunk, 0, COPY, size)) > 0; size += n) {
+            crc = crcUpdate(chunk.subarray(0, n), crc);
+            put(chunk.subarray(0, n), offset + size);
+          }
+        } finally { fs.closeSync(src); }
+      }
+      crc = (crc ^ 0xffffffff) >>> 0;
+      if (offset + size > LIMIT) throw new Error(`${dir} is over 4 GiB; the canonical zip does not write ZIP64`);
+      put(Buffer.concat([sig, common(crc, size, name), name]), start);
+      offset += size;
+      const head = Buffer.alloc(6);
+      head.writeUInt32LE(0x02014b50, 0);
+      head.writeUInt16LE((3 << 8) | 20, 4); // made by: Unix, 2.0
+      const tail = Buffer.alloc(14); // comment length, disk, internal attributes: 0
+      tail.writeUInt32LE(((e.mode << 16) | (e.dir ? 0x10 : 0)) >>> 0, 6);
+      tail.writeUInt32LE(start, 10);
+      central.push(Buffer.concat([head, common(crc, size, name), tail, name]));
+    }
+    const cd = Buffer.concat(central);
+    if (offset + cd.length > LIMIT) throw new Error(`${dir} is over 4 GiB; the canonical zip does not write ZIP64`);
+    const end = Buffer.alloc(22);
+    end.writeUInt32LE(0x06054b50, 0);
+    end.writeUInt16LE(list.length, 8);
+    end.writeUInt16LE(list.length, 10);
+    end.writeUInt32LE(cd.length, 12);
+    end.writeUInt32LE(offset, 16);
+    put(Buffer.concat([cd, end]), offset);
+  } finally {
+    fs.closeSync(fd);
+  }
+  return list.length;
+}
+
+module.exports = { writeCanonical };
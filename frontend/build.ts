@@ -0,0 +1,91 @@
+/**
+ * GitZipQR — Offline web build
+ * Produces dist/web/, a self-contained copy of the frontend for air-gapped use:
+ *   dist/web/frontend/  index.html, index.js, workers, sw.js
+ *   dist/web/shared/    capacity/frame/wasm/scrypt/blake3 modules
+ *   dist/web/vendor/    JSZip, qrcode and jsQR bundled from node_modules
+ * CDN URLs in the copied files are rewritten to the vendored copies; hash-wasm is
+ * dropped (scrypt runs on the bundled WASM SIMD kernel). The service worker cache
+ * name is stamped with a hash of the output so a new build replaces the old cache,
+ * and index.js gets OFFLINE_BUILD = true: only this build registers the worker.
+ *
+ * Usage: bun run build:web   (then serve dist/web/ over http(s), e.g. `bunx serve dist/web`)
+ */
+const fs = require('fs');
+const path = require('path');
+const crypto = require('crypto');
+
+const ROOT = path.join(__dirname, '..');
+const OUT = path.join(ROOT, 'dist', 'web');
+
+// CDN URL -> vendored file (null: not shipped offline)
+const VENDOR = {
+  'https://cdnjs.cloudflare.com/ajax/libs/jszip/3.10.1/jszip.min.js': { file: 'jszip.js', global: 'JSZip', pkg: 'jszip' },
+  'https://cdnjs.cloudflare.com/ajax/libs/qrcode/1.5.1/qrcode.min.js': { file: 'qrcode.js', global: 'QRCode', pkg: 'qrcode' },
+  'https://cdnjs.cloudflare.com/ajax/libs/jsqr/1.4.0/jsQR.min.js': { file: 'jsqr.js', global: 'jsQR', pkg: 'jsqr' },
+  'https://cdn.jsdelivr.net/npm/hash-wasm@4.12.0/dist/index.umd.min.js': null,
+};
+
+async function bundleVendor() {
+  const entries = path.join(ROOT, 'dist', '.web-entries');
+  fs.mkdirSync(entries, { recursive: true });
+  for (const lib of Object.values(VENDOR).filter(Boolean)) {
+    const entry = path.join(entries, lib.file);
+    fs.writeFileSync(entry, `const m = require('${lib.pkg}');\nself.${lib.global} = m.default || m;\n`);
+    const res = await Bun.build({ entrypoints: [entry], target: 'browser', format: 'iife', minify: true });
+    if (!res.success) throw new Error(`bundling ${lib.pkg} failed:\n` + res.logs.join('\n'));
+    fs.writeFileSync(path.join(OUT, 'vendor', lib.file), await res.outputs[0].text());
+    console.log(`vendor/${lib.file} <- ${lib.pkg}`);
+  }
+  fs.rmSync(entries, { recursive: true, force: true });
+}
+
+// Rewrites CDN references line by line; lines pointing at unshipped libraries are dropped.
+function localize(text) {
+  return text.split('\n').flatMap((line) => {
+    for (const [url, lib] of Object.entries(VENDOR)) {
+      if (!line.includes(url)) continue;
+      if (!lib) return [];
+      line = line.split(url).join('../vendor/' + lib.file);
+    }
+    return [line];
+  }).join('\n');
+}
+
+function copyDir(from, to, filter) {
+  for (const name of fs.readdirSync(from)) {
+    if (!filter(name)) continue;
+    const text = fs.readFileSync(path.join(from, name), 'utf8');
+    fs.writeFileSync(path.join(to, name), localize(text));
+  }
+}
+
+async function main() {
+  fs.rmSync(OUT, { recursive: true, force: true });
+  for (const dir of ['frontend', 'shared', 'vendor']) fs.mkdirSync(path.join(OUT, dir), { recursive: true });
+
+  await bundleVendor();
+  copyDir(path.join(ROOT, 'frontend'), path.join(OUT, 'frontend'), (n) => /\.(html|css|js)$/.test(n));
+  copyDir(path.join(ROOT, 'shared'), path.join(OUT, 'shared'), (n) => n.endsWith('.js'));
+  fs.writeFileSync(path.join(OUT, 'index.html'),
+    '<!DOCTYPE html><meta charset="UTF-8"><meta http-equiv="refresh" content="0; url=frontend/index.html">\n');
+
+  const hash = crypto.createHash('sha256');
+  for (const dir of ['frontend', 'shared', 'vendor']) {
+    for (const name of fs.readdirSync(path.join(OUT, dir)).sort()) hash.update(fs.readFileSync(path.join(OUT, dir, name)));
+  }
+  const sw = path.join(OUT, 'frontend', 'sw.js'), app = path.join(OUT, 'frontend', 'index.js');
+  const version = 'gitzipqr-' + hash.digest('hex').slice(0, 12);
+  const stamp = (file, from, to) => {
+    const text = fs.readFileSync(file, 'utf8');
+    if (!from.test(text)) throw new Error(`${path.relative(OUT, file)}: ${from} not found`);
+    fs.writeFileSync(file, text.replace(from, to));
+  };
+  stamp(sw, /const CACHE = '[^']*';/, `const CACHE = '${version}';`);
+  stamp(app, /const OFFLINE_BUILD = false;/, 'const OFFLINE_BUILD = true;');
+  // The offline shell must not depend on (or precache) any CDN.
+  if (/https?:\/\//.test(fs.readFileSync(sw, 'utf8'))) throw new Error('frontend/sw.js still lists a CDN URL after localizing');
+  console.log(`dist/web ready (cache ${version})`);
+}
+
+main().catch((e) => { console.error(e.message || e); process.exit(1); });
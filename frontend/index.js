@@ -6,7 +6,7 @@ const translations = {
     step1: "Zip the folder with normalized timestamps",
     step2: "Derive a key via scrypt and encrypt with AES-256-GCM",
     step3: "Split the ciphertext into QR-sized chunks",
-    step4: "Embed each chunk directly into a QR image (base64 payload)",
+    step4: "Embed each chunk directly into a QR image (binary payload)",
     step5: "To restore, scan all QR codes and decrypt using the same password",
     encryptTitle: "Encrypt Folder",
     decryptTitle: "Decrypt Folder",
@@ -184,84 +184,324 @@ function setMode(m) {
   }
   fileInput.value = '';
   selectedFiles = [];
+  warmPools();
 }
 
 modeEncrypt.addEventListener('click', () => setMode('encrypt'));
 modeDecrypt.addEventListener('click', () => setMode('decrypt'));
 
+/* ---------------- Worker pool ---------------- */
+// Same { id, task } protocol as core/pool.ts; workers stay alive between runs.
+class WorkerPool {
+  constructor(url, size) {
+    this.url = url;
+    this.size = Math.max(1, size | 0);
+    this.workers = [];
+    this.idle = [];
+    this.queue = [];
+    this.inflight = new Map();
+    this.seq = 0;
+  }
+
+  run(task, transfer) {
+    return new Promise(resolve => {
+      this.queue.push({ task, transfer, resolve });
+      this._pump();
+    });
+  }
+
+  _spawn() {
+    const w = new Worker(this.url);
+    w.onmessage = ({ data }) => {
+      const job = this.inflight.get(w);
+      if (!job || data.id !== job.id) return;
+      this.inflight.delete(w);
+      job.resolve(data);
+      this.idle.push(w);
+      this._pump();
+    };
+    w.onerror = (e) => {
+      e.preventDefault();
+      const job = this.inflight.get(w);
+      this.inflight.delete(w);
+      this.workers = this.workers.filter(x => x !== w);
+      w.terminate();
+      if (job) job.resolve({ ok: false, error: e.message || 'worker error' });
+      this._pump();
+    };
+    this.workers.push(w);
+    return w;
+  }
+
+  _pump() {
+    while (this.queue.length) {
+      let w = this.idle.pop();
+      if (!w) {
+        if (this.workers.length >= this.size) return;
+        w = this._spawn();
+      }
+      const { task, transfer, resolve } = this.queue.shift();
+      const id = ++this.seq;
+      this.inflight.set(w, { id, resolve });
+      w.postMessage({ id, task }, transfer || []);
+    }
+  }
+
+  // Starts every worker now so their importScripts/compile cost is paid before the first task.
+  warm() {
+    while (this.workers.length < this.size) this.idle.push(this._spawn());
+  }
+
+  destroy() {
+    for (const w of this.workers) w.terminate();
+    for (const job of this.inflight.values()) job.resolve({ ok: false, error: 'pool is closed' });
+    for (const job of this.queue) job.resolve({ ok: false, error: 'pool is closed' });
+    this.workers = []; this.idle = []; this.queue = []; this.inflight.clear();
+  }
+}
+
+const POOL_SIZE = Math.max(1, navigator.hardwareConcurrency || 4);
+const canRenderInWorkers = typeof Worker === 'function' && typeof OffscreenCanvas === 'function';
+const canDecodeInWorkers = canRenderInWorkers && typeof createImageBitmap === 'function';
+let qrPool = null, decodePool = null;
+function getQrPool() {
+  if (!qrPool) qrPool = new WorkerPool('qr.worker.js', POOL_SIZE);
+  return qrPool;
+}
+function getDecodePool() {
+  if (!decodePool) decodePool = new WorkerPool('qrdecode.worker.js', POOL_SIZE);
+  return decodePool;
+}
+// Spin up the pool for the current mode while the user is still picking files.
+function warmPools() {
+  const idle = window.requestIdleCallback || ((fn) => setTimeout(fn, 200));
+  idle(() => {
+    if (mode === 'encrypt' && canRenderInWorkers) getQrPool().warm();
+    if (mode === 'decrypt' && canDecodeInWorkers) getDecodePool().warm();
+  });
+}
+
+/* ---------------- Archive format ---------------- */
+// Same chunk frames and KDF as the CLI (shared/frame.js): archives encoded here
+// restore with `bun decode` and CLI archives restore here.
+const { FRAGMENT_TYPE, KCV_LABEL, encodeFrame, frameOverhead, parsePayload } = GitZipQRFrame;
+const QR_ECL = 'L';
+// Same defaults as the CLI: N = 2^15, r = 8, p = logical cores.
+const KDF = { N: 1 << 15, r: 8, p: POOL_SIZE };
+// Each lane worker holds 128 * r * N bytes (32 MiB at the defaults).
+const KDF_WORKERS = Math.min(POOL_SIZE, 8);
+// WebCrypto AES-GCM is one-shot, so the input (or its zip) and the ciphertext are
+// both held in memory; larger inputs are refused up front (use the CLI for those).
+const MAX_INPUT = 256 * 1024 * 1024;
+const tooLarge = (bytes) => new Error(`Input is ${(bytes / 1048576).toFixed(0)} MiB; the browser encoder is limited to ${MAX_INPUT / 1048576} MiB (use the CLI for larger inputs)`);
+
+// Compiled once at load and shared with every lane worker.
+const scryptModule = typeof WebAssembly === 'object' && GitZipQRScrypt.supported()
+  ? GitZipQRScrypt.compile().catch(() => null)
+  : Promise.resolve(null);
+
+// scrypt = PBKDF2(P, ROMix(B_0..B_p-1), 1) with B = PBKDF2(P, S, 1, p * 128r):
+// the PBKDF2 steps run on WebCrypto, the p ROMix lanes in parallel WASM SIMD workers.
+async function deriveKey(pw, salt, kdf) {
+  const { N, r, p } = kdf;
+  const module = typeof Worker === 'function' ? await scryptModule : null;
+  if (!module) {
+    // The offline bundle (frontend/build.ts) ships without hash-wasm.
+    if (typeof hashwasm === 'undefined') throw new Error('scrypt needs WebAssembly SIMD and Web Workers');
+    return hashwasm.scrypt({
+      password: pw, salt, costFactor: N, blockSize: r, parallelism: p,
+      hashLength: 32, outputType: 'binary',
+    });
+  }
+  const base = await crypto.subtle.importKey('raw', new TextEncoder().encode(pw), 'PBKDF2', false, ['deriveBits']);
+  const pbkdf2 = async (s, bytes) => new Uint8Array(
+    await crypto.subtle.deriveBits({ name: 'PBKDF2', salt: s, iterations: 1, hash: 'SHA-256' }, base, bytes * 8));
+  const bs = 128 * r;
+  const B = await pbkdf2(salt, p * bs);
+  // Short-lived pool: WASM memory cannot shrink, so workers go away with their V arrays.
+  const pool = new WorkerPool('scrypt.worker.js', Math.min(p, KDF_WORKERS));
+  try {
+    await Promise.all(Array.from({ length: p }, async (_, i) => {
+      const lane = B.slice(i * bs, (i + 1) * bs);
+      const res = await pool.run({ module, lane, N, r }, [lane.buffer]);
+      if (!res.ok) throw new Error('scrypt: ' + res.error);
+      B.set(res.lane, i * bs);
+    }));
+  } finally {
+    pool.destroy();
+  }
+  return pbkdf2(B, 32);
+}
+
+function toHex(bytes) {
+  return Array.from(bytes, b => b.toString(16).padStart(2, '0')).join('');
+}
+// Key check value stored in the chunk metadata (see shared/frame.js).
+async function keyCheckValue(rawKey) {
+  const mac = await crypto.subtle.importKey('raw', rawKey, { name: 'HMAC', hash: 'SHA-256' }, false, ['sign']);
+  return toHex(new Uint8Array(await crypto.subtle.sign('HMAC', mac, new TextEncoder().encode(KCV_LABEL)))).slice(0, 16);
+}
+// Derives the AES key for an archive and rejects early on a key check mismatch.
+async function unlockKey(pw, meta) {
+  const rawKey = await deriveKey(pw, fromBase64(meta.saltB64), meta.kdfParams);
+  if (meta.kcv && await keyCheckValue(rawKey) !== meta.kcv) throw new Error('Wrong password (key check value mismatch)');
+  return crypto.subtle.importKey('raw', rawKey, 'AES-GCM', false, ['decrypt']);
+}
+async function sha256Hex(bytes) {
+  return toHex(new Uint8Array(await crypto.subtle.digest('SHA-256', bytes)));
+}
+// Archives written with QR_HASH=blake3 (meta.hashAlg, payload 3.3) are checked with shared/blake3.js.
+let blake3Hasher = null;
+async function blake3Hex(bytes) {
+  if (!blake3Hasher) blake3Hasher = GitZipQRBlake3.create();
+  return toHex(blake3Hasher.hash(bytes));
+}
+function smallBase64(bytes) { return btoa(String.fromCharCode(...bytes)); }
+
+// Renders chunk i -> PNG Blob for every i in [0, count), at most `limit` in flight,
+// handing each result to onImage as soon as it is ready.
+async function renderChunks(count, chunkAt, onImage, limit = POOL_SIZE * 2) {
+  let next = 0, done = 0;
+  async function lane() {
+    while (next < count) {
+      const i = next++;
+      const data = await chunkAt(i);
+      let blob;
+      if (canRenderInWorkers) {
+        const res = await getQrPool().run({ data, ecl: QR_ECL }, [data.buffer]);
+        if (!res.ok) throw new Error(res.error);
+        blob = res.blob;
+      } else {
+        const dataUrl = await QRCode.toDataURL([{ data, mode: 'byte' }], { errorCorrectionLevel: QR_ECL });
+        blob = await (await fetch(dataUrl)).blob();
+      }
+      await onImage(i, blob);
+      if (++done % 50 === 0 || done === count) log(`QR ${done}/${count} rendered`);
+    }
+  }
+  await Promise.all(Array.from({ length: Math.min(limit, count) }, lane));
+}
+
+// Where rendered PNGs go. With the File System Access API each PNG is written
+// to a user-chosen directory as soon as it is rendered, so memory stays bounded
+// by the render window; otherwise they are collected into qrcodes.zip.
+async function openQrSink() {
+  if (typeof window.showDirectoryPicker === 'function') {
+    let dir = null;
+    try {
+      dir = await window.showDirectoryPicker({ id: 'gitzipqr-out', mode: 'readwrite', startIn: 'downloads' });
+    } catch (e) {
+      if (e.name === 'AbortError') throw new Error('No output directory selected');
+    }
+    if (dir) {
+      return {
+        where: dir.name + '/',
+        async write(name, blob) {
+          const file = await dir.getFileHandle(name, { create: true });
+          const out = await file.createWritable();
+          await out.write(blob);
+          await out.close();
+        },
+        async close() {},
+      };
+    }
+  }
+  const zip = new JSZip();
+  return {
+    where: 'qrcodes.zip',
+    async write(name, blob) { zip.file(name, blob); },
+    async close() {
+      // PNGs are already deflated; storing them avoids a second compression pass.
+      const content = await zip.generateAsync({ type: 'blob', compression: 'STORE', streamFiles: true });
+      const a = document.createElement('a');
+      a.href = URL.createObjectURL(content);
+      a.download = 'qrcodes.zip';
+      a.click();
+      setTimeout(() => URL.revokeObjectURL(a.href), 60000);
+    },
+  };
+}
+
 async function encryptFolder() {
   if (!selectedFiles.length) { log('No files selected'); return; }
   const pwEls = passwordsDiv.querySelectorAll('input');
   const pw = Array.from(pwEls).map(i => i.value).filter(Boolean).join('\u0000');
   if (!pw) { log('No passwords provided'); return; }
-  log('Encrypting folder ...');
+  const inputBytes = selectedFiles.reduce((n, f) => n + f.size, 0);
+  if (inputBytes > MAX_INPUT) { log('Error: ' + tooLarge(inputBytes).message); return; }
   try {
-    let data;
-    let ext;
+    // Ask for the output directory first, while the click still counts as a user gesture.
+    const sink = await openQrSink();
+    log('Encrypting folder ...');
+    // Key derivation only needs the password and salt, so it runs while the input is zipped.
+    const salt = crypto.getRandomValues(new Uint8Array(16));
+    const nonce = crypto.getRandomValues(new Uint8Array(12));
+    const kdf = { ...KDF };
+    const keyJob = deriveKey(pw, salt, kdf);
+    keyJob.catch(() => {});
+    let data, name, ext;
     if (selectedFiles.length === 1 && !(selectedFiles[0].webkitRelativePath || selectedFiles[0].relativePath)) {
       const file = selectedFiles[0];
       data = new Uint8Array(await file.arrayBuffer());
       const idx = file.name.lastIndexOf('.');
-      ext = idx >= 0 ? file.name.slice(idx + 1) : '';
+      name = idx > 0 ? file.name.slice(0, idx) : file.name;
+      ext = idx > 0 ? file.name.slice(idx) : '';
     } else {
+      // Like the CLI, zip the folder's contents (without the folder itself) and name the archive after it.
+      const paths = selectedFiles.map(f => f.webkitRelativePath || f.relativePath || f.name);
+      const root = paths[0].includes('/') ? paths[0].split('/')[0] : '';
+      const strip = root && paths.every(p => p.startsWith(root + '/')) ? root.length + 1 : 0;
       const zipSrc = new JSZip();
-      for (const file of selectedFiles) {
-        const path = file.webkitRelativePath || file.relativePath || file.name;
-        zipSrc.file(path, file);
-      }
+      selectedFiles.forEach((file, i) => zipSrc.file(paths[i].slice(strip), file));
       data = await zipSrc.generateAsync({ type: 'uint8array' });
-      ext = 'zip';
-    }
-    const enc = new TextEncoder();
-    const pwKey = await crypto.subtle.importKey('raw', enc.encode(pw), 'PBKDF2', false, ['deriveKey']);
-    const salt = crypto.getRandomValues(new Uint8Array(16));
-    const key = await crypto.subtle.deriveKey({ name: 'PBKDF2', salt, iterations: 100000, hash: 'SHA-256' }, pwKey, { name: 'AES-GCM', length: 256 }, false, ['encrypt']);
-    const iv = crypto.getRandomValues(new Uint8Array(12));
-    const cipher = await crypto.subtle.encrypt({ name: 'AES-GCM', iv }, key, data);
-    const extBytes = new TextEncoder().encode(ext);
-    const out = new Uint8Array(1 + extBytes.length + salt.length + iv.length + cipher.byteLength);
-    let offset = 0;
-    out[offset++] = extBytes.length;
-    out.set(extBytes, offset); offset += extBytes.length;
-    out.set(salt, offset); offset += salt.length;
-    out.set(iv, offset); offset += iv.length;
-    out.set(new Uint8Array(cipher), offset);
-
-    function toBase64(bytes) {
-      let binary = '';
-      const len = bytes.length;
-      for (let i = 0; i < len; i++) binary += String.fromCharCode(bytes[i]);
-      return btoa(binary);
+      if (data.length > MAX_INPUT) throw tooLarge(data.length);
+      name = root || 'archive';
+      ext = '.zip';
     }
+    const rawKey = await keyJob;
+    const key = await crypto.subtle.importKey('raw', rawKey, 'AES-GCM', false, ['encrypt']);
+    // WebCrypto appends the 16-byte tag, matching the CLI's payload.enc layout.
+    const cipher = new Uint8Array(await crypto.subtle.encrypt({ name: 'AES-GCM', iv: nonce }, key, data));
+    data = null;
 
-    const base64 = toBase64(out);
-    let chunkSize = 2500;
-    while (chunkSize > 100) {
-      try {
-        await QRCode.toDataURL('a'.repeat(chunkSize), { errorCorrectionLevel: 'L' });
-        break;
-      } catch (err) {
-        if (err.message && err.message.includes('too big')) chunkSize -= 100; else throw err;
-      }
-    }
-    const zip = new JSZip();
-    let count = 0;
-    for (let i = 0; i < base64.length; i += chunkSize) {
-      const chunk = base64.slice(i, i + chunkSize);
-      const dataUrl = await QRCode.toDataURL(chunk, { errorCorrectionLevel: 'L' });
-      zip.file(`qr-${++count}.png`, dataUrl.split(',')[1], { base64: true });
-    }
-    const content = await zip.generateAsync({ type: 'blob' });
-    const a = document.createElement('a');
-    a.href = URL.createObjectURL(content);
-    a.download = 'qrcodes.zip';
-    a.click();
-    log('Encryption complete. QR codes: ' + count);
+    const cipherHash = await sha256Hex(cipher);
+    const baseMeta = {
+      type: FRAGMENT_TYPE,
+      version: '3.2-binary',
+      fileId: (await sha256Hex(new TextEncoder().encode(name + ':' + cipherHash))).slice(0, 16),
+      name,
+      ext,
+      chunk: 0, total: 1,
+      hash: ''.padStart(64, '0'),
+      cipherHash,
+      kdfParams: kdf,
+      saltB64: smallBase64(salt),
+      nonceB64: smallBase64(nonce),
+      kcv: await keyCheckValue(rawKey),
+      chunkSize: 0
+    };
+    const worst = frameOverhead({ ...baseMeta, chunk: 9999999999, total: 9999999999, chunkSize: 99999 });
+    const chunkSize = GitZipQRCapacity.byteCapacity(40, QR_ECL) - worst;
+    const count = Math.ceil(cipher.length / chunkSize);
+
+    await renderChunks(count, async (i) => {
+      const chunk = cipher.subarray(i * chunkSize, (i + 1) * chunkSize);
+      return encodeFrame({ ...baseMeta, chunk: i, total: count, hash: await sha256Hex(chunk), chunkSize }, chunk);
+    }, (i, blob) => sink.write(`qr-${String(i).padStart(6, '0')}.png`, blob));
+    await sink.close();
+    log(`Encryption complete. QR codes: ${count} -> ${sink.where}`);
   } catch (e) {
     log('Error: ' + e.message);
   }
 }
 
+function concatBytes(parts, total = parts.reduce((n, p) => n + p.length, 0)) {
+  const out = new Uint8Array(total);
+  let offset = 0;
+  for (const p of parts) { out.set(p, offset); offset += p.length; }
+  return out;
+}
+
 async function fileToImageData(file) {
   return new Promise((resolve, reject) => {
     const reader = new FileReader();
@@ -290,40 +530,123 @@ function fromBase64(b64) {
   return bytes;
 }
 
-async function ensureJsQR() {
-  if (typeof window !== 'undefined' && typeof window.jsQR === 'function') {
-    return window.jsQR;
+// Streaming base64 -> bytes: QR texts may split a 4-char quantum, so the tail is
+// carried into the next push; the output is concatenated once at the end.
+class Base64Sink {
+  constructor() { this.parts = []; this.carry = ''; this.length = 0; }
+  push(text) {
+    const s = this.carry + text.replace(/\s+/g, '');
+    const n = s.length - (s.length % 4);
+    this.carry = s.slice(n);
+    if (n) { const bytes = fromBase64(s.slice(0, n)); this.parts.push(bytes); this.length += bytes.length; }
+  }
+  finish() {
+    if (this.carry) throw new Error('Truncated base64 payload');
+    return concatBytes(this.parts, this.length);
   }
-  return new Promise((resolve, reject) => {
-    const script = document.createElement('script');
-    script.src = 'https://cdnjs.cloudflare.com/ajax/libs/jsqr/1.4.0/jsQR.min.js';
-    script.onload = () => {
-      if (typeof window.jsQR === 'function') resolve(window.jsQR);
-      else reject(new Error('jsQR did not initialize'));
-    };
-    script.onerror = () => reject(new Error('Failed to load jsQR script'));
-    document.head.appendChild(script);
-  });
 }
 
+// Returns { text, bytes }. Binary frames need the exact byte-mode payload, which
+// only jsQR exposes (BarcodeDetector hands back a decoded string).
 async function decodeQR(file) {
   if (typeof window !== 'undefined' && 'BarcodeDetector' in window) {
     try {
       const detector = new BarcodeDetector({ formats: ['qr_code'] });
       const bitmap = await createImageBitmap(file);
       const [code] = await detector.detect(bitmap);
-      if (code) return code.rawValue;
+      if (code && !code.rawValue.startsWith('GZQR')) return { text: code.rawValue, bytes: null };
     } catch (_) {}
   }
-  let jsqr;
-  try {
-    jsqr = await ensureJsQR();
-  } catch {
-    throw new Error('jsQR is not available');
-  }
+  if (typeof jsQR !== 'function') throw new Error('jsQR is not available');
   const img = await fileToImageData(file);
-  const qr = jsqr(img.data, img.width, img.height);
-  return qr ? qr.data : '';
+  const qr = jsQR(img.data, img.width, img.height);
+  return qr ? { text: qr.data, bytes: Uint8Array.from(qr.binaryData) } : { text: '', bytes: null };
+}
+
+// Decodes every file (at most `limit` bitmaps alive at once) and returns
+// { text, bytes } results in input order. onResult sees each result as it
+// lands; setting abort.error stops the scan and rejects with that error.
+async function decodeFiles(files, { limit = POOL_SIZE * 2, onResult = () => {}, abort = {} } = {}) {
+  const results = new Array(files.length);
+  let next = 0, done = 0;
+  async function lane() {
+    while (next < files.length && !abort.error) {
+      const i = next++;
+      if (canDecodeInWorkers) {
+        const bitmap = await createImageBitmap(files[i]);
+        const res = await getDecodePool().run({ bitmap }, [bitmap]);
+        if (!res.ok) log(`Skipping ${files[i].name}: ${res.error}`);
+        results[i] = res.ok ? res : { text: '', bytes: null };
+      } else {
+        results[i] = await decodeQR(files[i]);
+      }
+      onResult(results[i]);
+      if (++done % 50 === 0 || done === files.length) log(`QR ${done}/${files.length} read`);
+    }
+  }
+  await Promise.all(Array.from({ length: Math.min(limit, files.length) }, lane));
+  if (abort.error) throw abort.error;
+  return results;
+}
+
+// Chunk frames (CLI JSON or binary) -> ciphertext, verified per chunk and globally.
+async function assembleChunks(frames) {
+  // Linked parts after the first carry no archive metadata; take it from a part-0 frame.
+  const { meta } = frames.find(f => typeof f.meta.total === 'number') || frames[0];
+  const fileId = meta.fileId;
+  const acc = new Map();
+  for (const { meta: m, data } of frames) {
+    if (m.fileId !== fileId) continue;
+    if (!acc.has(m.chunk)) acc.set(m.chunk, { parts: [], total: m.partTotal || 1, hash: null });
+    const entry = acc.get(m.chunk);
+    entry.parts[typeof m.part === 'number' ? m.part : 0] = data;
+    if (m.hash) entry.hash = m.hash;
+  }
+  const chunks = [];
+  for (let i = 0; i < meta.total; i++) {
+    const entry = acc.get(i);
+    if (!entry) throw new Error(`Missing QR chunk ${i + 1}/${meta.total}`);
+    for (let p = 0; p < entry.total; p++) if (!entry.parts[p]) throw new Error(`Missing QR part ${p + 1}/${entry.total} of chunk ${i + 1}`);
+    chunks[i] = entry.total > 1 ? concatBytes(entry.parts) : entry.parts[0];
+  }
+  const alg = meta.hashAlg || 'sha256';
+  if (alg !== 'sha256' && alg !== 'blake3') throw new Error(`Unsupported chunk hash ${alg}`);
+  const digest = alg === 'blake3' ? blake3Hex : sha256Hex;
+  const hashes = await Promise.all(chunks.map(digest));
+  hashes.forEach((h, i) => { if (h !== acc.get(i).hash) throw new Error(`Chunk hash mismatch: chunk ${i + 1}`); });
+  const cipher = concatBytes(chunks);
+  if (meta.cipherHash && (await digest(cipher)) !== meta.cipherHash) throw new Error(`Global ${alg} mismatch`);
+  return { meta, cipher };
+}
+
+async function decryptArchive(pw, frames, keyJob) {
+  const { meta, cipher } = await assembleChunks(frames);
+  const nonce = fromBase64(meta.nonceB64);
+  const key = await (keyJob || unlockKey(pw, meta));
+  const plain = await crypto.subtle.decrypt({ name: 'AES-GCM', iv: nonce }, key, cipher);
+  let ext = String(meta.ext || '');
+  if (ext && !ext.startsWith('.')) ext = '.' + ext;
+  return { plain, fileName: meta.name + ext };
+}
+
+// Archives from the original browser encoder (1.3.x web page): PBKDF2 key and
+// ext/salt/iv in-band, as base64 text split over QR images in file-name order.
+async function decryptLegacy(pw, results) {
+  const sink = new Base64Sink();
+  for (const { text } of results) sink.push(text);
+  const bytes = sink.finish();
+  let offset = 0;
+  const extLen = bytes[offset++];
+  const ext = new TextDecoder().decode(bytes.slice(offset, offset + extLen));
+  offset += extLen;
+  const salt = bytes.slice(offset, offset + 16); offset += 16;
+  const iv = bytes.slice(offset, offset + 12); offset += 12;
+  const cipher = bytes.slice(offset);
+  const enc = new TextEncoder();
+  const pwKey = await crypto.subtle.importKey('raw', enc.encode(pw), 'PBKDF2', false, ['deriveKey']);
+  const key = await crypto.subtle.deriveKey({ name: 'PBKDF2', salt, iterations: 100000, hash: 'SHA-256' }, pwKey, { name: 'AES-GCM', length: 256 }, false, ['decrypt']);
+  const plain = await crypto.subtle.decrypt({ name: 'AES-GCM', iv }, key, cipher);
+  return { plain, fileName: `decoded.${ext || 'bin'}` };
 }
 
 async function decryptFolder() {
@@ -333,28 +656,31 @@ async function decryptFolder() {
   if (!pw) { log('No passwords provided'); return; }
   log('Decrypting folder ...');
   try {
-    const files = selectedFiles.slice().sort((a,b)=>a.name.localeCompare(b.name));
-    let base64 = '';
-    for (const file of files) {
-      base64 += await decodeQR(file);
-    }
-    const bytes = fromBase64(base64);
-    let offset = 0;
-    const extLen = bytes[offset++];
-    const ext = new TextDecoder().decode(bytes.slice(offset, offset + extLen));
-    offset += extLen;
-    const salt = bytes.slice(offset, offset + 16); offset += 16;
-    const iv = bytes.slice(offset, offset + 12); offset += 12;
-    const cipher = bytes.slice(offset);
-    const enc = new TextEncoder();
-    const pwKey = await crypto.subtle.importKey('raw', enc.encode(pw), 'PBKDF2', false, ['deriveKey']);
-    const key = await crypto.subtle.deriveKey({ name: 'PBKDF2', salt, iterations: 100000, hash: 'SHA-256' }, pwKey, { name: 'AES-GCM', length: 256 }, false, ['decrypt']);
-    const plain = await crypto.subtle.decrypt({ name: 'AES-GCM', iv }, key, cipher);
+    // File order only matters for legacy base64 archives; frames carry their chunk index.
+    const files = selectedFiles.slice().sort((a, b) => a.name.localeCompare(b.name, undefined, { numeric: true }));
+    // scrypt starts with the first chunk and runs while the rest are read.
+    let keyJob = null;
+    const abort = {};
+    const results = await decodeFiles(files, {
+      abort,
+      onResult(r) {
+        if (keyJob) return;
+        const f = parsePayload(r.text, r.bytes);
+        if (!(f && f.meta.type === FRAGMENT_TYPE && f.meta.saltB64)) return;
+        keyJob = unlockKey(pw, f.meta);
+        keyJob.catch(e => { abort.error = e; });
+      },
+    });
+    const parsed = results.map(r => parsePayload(r.text, r.bytes)).filter(Boolean);
+    const current = parsed.filter(f => f.meta.type === FRAGMENT_TYPE);
+    const { plain, fileName } = current.length
+      ? await decryptArchive(pw, current, keyJob)
+      : await decryptLegacy(pw, results);
     const a = document.createElement('a');
     a.href = URL.createObjectURL(new Blob([plain]));
-    a.download = `decoded.${ext || 'bin'}`;
+    a.download = fileName;
     a.click();
-    log('Decryption complete. Extension: .' + ext);
+    log('Decryption complete. File: ' + fileName);
   } catch (e) {
     log('Error: ' + e.message);
   }
@@ -374,3 +700,12 @@ actionBtn.addEventListener('click', () => {
 });
 
 setMode('encrypt');
+
+// Cache the app shell and vendored libraries for offline use (see sw.js). Only the
+// stamped dist/web build registers it (frontend/build.ts sets OFFLINE_BUILD); the
+// source tree drops a worker left over from earlier so edits show up on reload.
+const OFFLINE_BUILD = false;
+if ('serviceWorker' in navigator && /^https?:$/.test(location.protocol)) {
+  if (OFFLINE_BUILD) navigator.serviceWorker.register('sw.js').catch(e => console.warn('service worker:', e.message));
+  else navigator.serviceWorker.getRegistrations().then(rs => rs.forEach(r => r.unregister())).catch(() => {});
+}
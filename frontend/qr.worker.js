@@ -0,0 +1,41 @@
+/**
+ * QR render worker (browser)
+ * Builds the QR matrix with qrcode and paints it on an OffscreenCanvas,
+ * returning a PNG Blob. Same { id, task } protocol as core/pool.ts.
+ */
+importScripts('https://cdnjs.cloudflare.com/ajax/libs/qrcode/1.5.1/qrcode.min.js');
+
+const BLACK = 0xff000000; // RGBA bytes 00 00 00 ff read as little-endian u32
+const WHITE = 0xffffffff;
+
+// `data` is a Uint8Array (encoded as one byte-mode segment) or a string.
+function renderQR(data, { ecl = 'L', margin = 4, scale = 4 } = {}) {
+  const segments = typeof data === 'string' ? data : [{ data, mode: 'byte' }];
+  const qr = QRCode.create(segments, { errorCorrectionLevel: ecl });
+  const size = qr.modules.size;
+  const bits = qr.modules.data;
+  const px = (size + margin * 2) * scale;
+  const canvas = new OffscreenCanvas(px, px);
+  const ctx = canvas.getContext('2d');
+  const img = ctx.createImageData(px, px);
+  const pixels = new Uint32Array(img.data.buffer);
+  pixels.fill(WHITE);
+  for (let r = 0; r < size; r++) {
+    for (let c = 0; c < size; c++) {
+      if (!bits[r * size + c]) continue;
+      const y0 = (r + margin) * scale, x0 = (c + margin) * scale;
+      for (let y = y0; y < y0 + scale; y++) pixels.fill(BLACK, y * px + x0, y * px + x0 + scale);
+    }
+  }
+  ctx.putImageData(img, 0, 0);
+  return canvas.convertToBlob({ type: 'image/png' });
+}
+
+self.onmessage = async ({ data: { id, task } }) => {
+  try {
+    const blob = await renderQR(task.data, task);
+    self.postMessage({ id, ok: true, blob });
+  } catch (e) {
+    self.postMessage({ id, ok: false, error: String(e && e.message || e) });
+  }
+};
@@ -0,0 +1,73 @@
+/**
+ * QR decode worker (browser)
+ * Receives a transferred ImageBitmap and returns { text, bytes }.
+ * BarcodeDetector (when the worker exposes it) answers plain-text symbols
+ * directly; for binary frames it only locates the symbol and jsQR reads the
+ * exact byte-mode payload from the cropped region.
+ */
+importScripts('https://cdnjs.cloudflare.com/ajax/libs/jsqr/1.4.0/jsQR.min.js');
+
+let detectorReady = null;
+function getDetector() {
+  if (!detectorReady) {
+    detectorReady = (async () => {
+      if (typeof BarcodeDetector === 'undefined') return null;
+      const formats = await BarcodeDetector.getSupportedFormats();
+      return formats.includes('qr_code') ? new BarcodeDetector({ formats: ['qr_code'] }) : null;
+    })().catch(() => null);
+  }
+  return detectorReady;
+}
+
+let canvas = null, ctx = null;
+function pixels(bitmap, x, y, w, h) {
+  if (!canvas || canvas.width < w || canvas.height < h) {
+    canvas = new OffscreenCanvas(w, h);
+    ctx = canvas.getContext('2d', { willReadFrequently: true });
+  }
+  ctx.clearRect(0, 0, w, h);
+  ctx.drawImage(bitmap, x, y, w, h, 0, 0, w, h);
+  return ctx.getImageData(0, 0, w, h);
+}
+
+function readJsQR(bitmap, box) {
+  const { x, y, width, height } = box;
+  const img = pixels(bitmap, x, y, width, height);
+  const qr = jsQR(img.data, img.width, img.height, { inversionAttempts: 'dontInvert' })
+    || jsQR(img.data, img.width, img.height, { inversionAttempts: 'onlyInvert' });
+  return qr ? { text: qr.data, bytes: Uint8Array.from(qr.binaryData) } : null;
+}
+
+async function decode(bitmap) {
+  const full = { x: 0, y: 0, width: bitmap.width, height: bitmap.height };
+  const detector = await getDetector();
+  if (detector) {
+    const [code] = await detector.detect(bitmap).catch(() => []);
+    if (code && !code.rawValue.startsWith('GZQR')) return { text: code.rawValue, bytes: null };
+    if (code) {
+      // Crop to the detected symbol plus a quiet-zone margin before running jsQR.
+      const b = code.boundingBox, pad = Math.ceil(Math.max(b.width, b.height) * 0.1);
+      const x = Math.max(0, Math.floor(b.x) - pad), y = Math.max(0, Math.floor(b.y) - pad);
+      const box = {
+        x, y,
+        width: Math.min(bitmap.width, Math.ceil(b.x + b.width) + pad) - x,
+        height: Math.min(bitmap.height, Math.ceil(b.y + b.height) + pad) - y,
+      };
+      const hit = readJsQR(bitmap, box);
+      if (hit) return hit;
+    }
+  }
+  return readJsQR(bitmap, full) || { text: '', bytes: null };
+}
+
+self.onmessage = async ({ data: { id, task } }) => {
+  const { bitmap } = task;
+  try {
+    const res = await decode(bitmap);
+    self.postMessage({ id, ok: true, ...res }, res.bytes ? [res.bytes.buffer] : []);
+  } catch (e) {
+    self.postMessage({ id, ok: false, error: String(e && e.message || e) });
+  } finally {
+    bitmap.close();
+  }
+};
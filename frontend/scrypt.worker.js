@@ -0,0 +1,19 @@
+/**
+ * scrypt lane worker (browser)
+ * Runs ROMix for one scrypt lane with the WASM SIMD kernel from shared/scrypt.js.
+ * The compiled WebAssembly.Module comes with the task, so it is compiled once per page.
+ */
+importScripts('../shared/wasm.js', '../shared/scrypt.js');
+
+let kernel = null;
+
+self.onmessage = ({ data: { id, task } }) => {
+  try {
+    if (!kernel) kernel = GitZipQRScrypt.instantiate(task.module);
+    const { lane } = task;
+    kernel.romix(lane, task.N, task.r);
+    self.postMessage({ id, ok: true, lane }, [lane.buffer]);
+  } catch (e) {
+    self.postMessage({ id, ok: false, error: String(e && e.message || e) });
+  }
+};
@@ -0,0 +1,63 @@
+/**
+ * GitZipQR service worker
+ * Precaches the app shell, the shared modules and the vendored libraries, then
+ * serves everything cache-first so the frontend keeps working offline
+ * (air-gapped recovery machines load it once from a local copy or USB stick).
+ * Only the dist/web build registers it: frontend/build.ts stamps CACHE with a
+ * content hash and rewrites VENDOR to the bundled copies. Should the unstamped
+ * source version ever run, it goes to the network first and uses the cache
+ * only offline, so it never pins stale code.
+ */
+const CACHE = 'gitzipqr-dev';
+const STAMPED = CACHE !== 'gitzipqr-dev';
+const VENDOR = [
+  'https://cdnjs.cloudflare.com/ajax/libs/jszip/3.10.1/jszip.min.js',
+  'https://cdnjs.cloudflare.com/ajax/libs/qrcode/1.5.1/qrcode.min.js',
+  'https://cdnjs.cloudflare.com/ajax/libs/jsqr/1.4.0/jsQR.min.js',
+  'https://cdn.jsdelivr.net/npm/hash-wasm@4.12.0/dist/index.umd.min.js',
+];
+const SHELL = [
+  './', 'index.html', 'index.css', 'index.js',
+  'qr.worker.js', 'qrdecode.worker.js', 'scrypt.worker.js',
+  '../shared/capacity.js', '../shared/frame.js', '../shared/wasm.js', '../shared/scrypt.js', '../shared/blake3.js',
+  ...VENDOR,
+];
+
+self.addEventListener('install', (e) => {
+  e.waitUntil((async () => {
+    const cache = await caches.open(CACHE);
+    // One unreachable CDN must not block the rest of the shell from caching.
+    await Promise.all(SHELL.map(url => cache.add(url).catch(() => {})));
+    await self.skipWaiting();
+  })());
+});
+
+self.addEventListener('activate', (e) => {
+  e.waitUntil((async () => {
+    for (const key of await caches.keys()) if (key !== CACHE) await caches.delete(key);
+    await self.clients.claim();
+  })());
+});
+
+self.addEventListener('fetch', (e) => {
+  if (e.request.method !== 'GET') return;
+  e.respondWith((async () => {
+    const cache = await caches.open(CACHE);
+    if (!STAMPED) {
+      try {
+        const res = await fetch(e.request);
+        if (res.ok) cache.put(e.request, res.clone());
+        return res;
+      } catch (err) {
+        const hit = await cache.match(e.request, { ignoreSearch: true });
+        if (hit) return hit;
+        throw err;
+      }
+    }
+    const hit = await cache.match(e.request, { ignoreSearch: true });
+    if (hit) return hit;
+    const res = await fetch(e.request);
+    if (res.ok) cache.put(e.request, res.clone());
+    return res;
+  })());
+});
@@ -0,0 +1,235 @@
+/**
+ * GitZipQR — adaptive binarization in WebAssembly SIMD
+ * luma:      RGBA -> gray, (77 R + 150 G + 29 B) >> 8, 16 pixels per step.
+ * threshold: integral image over an edge-padded gray plane, then a pixel is
+ *            light when it is brighter than (1 - bias) x the mean of its
+ *            (2r + 1)^2 window (Bradley-Roth), 16 pixels per step. Output is
+ *            0 (dark) / 255 (light).
+ * The scalar versions (lumaJs, thresholdJs) compute identical results. They are
+ * the fallback where SIMD is missing and the baseline for `bun run bench binarize`.
+ *
+ * Memory: padded gray G, integral I (u32, (W + 1) x (H + 1)), output O.
+ * Loads as CommonJS (require) or as a classic script (self.GitZipQRBinarize).
+ */
+(function (root, factory) {
+  if (typeof module === 'object' && module.exports) module.exports = factory(require('./wasm'));
+  else root.GitZipQRBinarize = factory(root.GitZipQRWasm);
+})(typeof self !== 'undefined' ? self : this, function ({ I, buildModule }) {
+  const SLACK = 64; // vector loops may read/write up to one step past each buffer
+  const K = 128; // fixed-point scale of the bias
+
+  const WEIGHTS = [77, 0, 150, 0, 29, 0, 0, 0, 77, 0, 150, 0, 29, 0, 0, 0]; // i16x8 R, G, B, A per pixel
+
+  // luma(src, dst, end): 16 RGBA pixels -> 16 gray bytes per iteration until dst >= end
+  const L = { SRC: 0, DST: 1, END: 2, T: 3, A: 4, B: 5 };
+  const gray4 = (off) => [
+    I.get(L.SRC), I.v128_load(off), I.tee(L.T), I.i16x8_extend_low_u8x16, I.v128_const(WEIGHTS), I.i32x4_dot_i16x8_s, I.set(L.A),
+    I.get(L.T), I.i16x8_extend_high_u8x16, I.v128_const(WEIGHTS), I.i32x4_dot_i16x8_s, I.set(L.B),
+    I.get(L.A), I.get(L.B), I.i32x4_shuffle(0, 2, 4, 6), I.get(L.A), I.get(L.B), I.i32x4_shuffle(1, 3, 5, 7),
+    I.i32x4_add, I.i32_const(8), I.i32x4_shr_u,
+  ];
+  const luma = {
+    name: 'luma',
+    params: ['i32', 'i32', 'i32'],
+    locals: ['v128', 'v128', 'v128'],
+    body: [
+      I.loop(
+        I.get(L.DST),
+        gray4(0), gray4(16), I.i16x8_narrow_i32x4_u,
+        gray4(32), gray4(48), I.i16x8_narrow_i32x4_u,
+        I.i8x16_narrow_i16x8_u, I.v128_store(),
+        I.get(L.SRC), I.i32_const(64), I.i32_add, I.set(L.SRC),
+        I.get(L.DST), I.i32_const(16), I.i32_add, I.tee(L.DST),
+        I.get(L.END), I.i32_lt_u, I.br_if(0),
+      ),
+    ],
+  };
+
+  // integral(G, I, W, H): I[y + 1][x + 1] = sum of G[0..y][0..x]; row 0 must be zero.
+  const N = { G: 0, IP: 1, W: 2, H: 3, Y: 4, S: 5, PG: 6, PI: 7, PREV: 8, END: 9, ROW: 10 };
+  const integral = {
+    name: 'integral',
+    params: ['i32', 'i32', 'i32', 'i32'],
+    locals: ['i32', 'i32', 'i32', 'i32', 'i32', 'i32', 'i32'],
+    body: [
+      I.get(N.G), I.set(N.PG),
+      I.get(N.IP), I.get(N.W), I.i32_const(1), I.i32_add, I.i32_const(4), I.i32_mul, I.tee(N.ROW), I.i32_add, I.set(N.PREV), // -> row 1
+      I.i32_const(0), I.set(N.Y),
+      I.loop(
+        // row prefix sums (scalar)
+        I.get(N.PREV), I.i32_const(0), I.i32_store(),
+        I.i32_const(0), I.set(N.S),
+        I.get(N.PREV), I.i32_const(4), I.i32_add, I.tee(N.PI), I.get(N.W), I.i32_const(4), I.i32_mul, I.i32_add, I.set(N.END),
+        I.loop(
+          I.get(N.PI),
+          I.get(N.S), I.get(N.PG), I.i32_load8_u(), I.i32_add, I.tee(N.S),
+          I.i32_store(),
+          I.get(N.PG), I.i32_const(1), I.i32_add, I.set(N.PG),
+          I.get(N.PI), I.i32_const(4), I.i32_add, I.tee(N.PI),
+          I.get(N.END), I.i32_lt_u, I.br_if(0),
+        ),
+        // add the row above, four columns at a time
+        I.get(N.PREV), I.tee(N.PI), I.get(N.ROW), I.i32_add, I.set(N.END),
+        I.loop(
+          I.get(N.PI),
+          I.get(N.PI), I.v128_load(),
+          I.get(N.PI), I.get(N.ROW), I.i32_sub, I.v128_load(),
+          I.i32x4_add, I.v128_store(),
+          I.get(N.PI), I.i32_const(16), I.i32_add, I.tee(N.PI),
+          I.get(N.END), I.i32_lt_u, I.br_if(0),
+        ),
+        I.get(N.PREV), I.get(N.ROW), I.i32_add, I.set(N.PREV),
+        I.get(N.Y), I.i32_const(1), I.i32_add, I.tee(N.Y),
+        I.get(N.H), I.i32_lt_u, I.br_if(0),
+      ),
+    ],
+  };
+
+  // threshold(G, I, O, w, h, r, area, scale): O[y][x] = G'[y][x] * area > sum * scale ? 255 : 0,
+  // where G' is G without its r-pixel padding and sum covers the (2r + 1)^2 window.
+  const R = {
+    G: 0, IP: 1, O: 2, W: 3, H: 4, RAD: 5, AREA: 6, SCALE: 7,
+    Y: 8, PG: 9, PO: 10, END: 11, P00: 12, P01: 13, P10: 14, P11: 15, STRIDE: 16, GS: 17, VA: 18, VS: 19, LO: 20, HI: 21,
+  };
+  const window4 = (j) => [
+    I.get(R.P11), I.v128_load(j * 16), I.get(R.P01), I.v128_load(j * 16), I.i32x4_sub,
+    I.get(R.P10), I.v128_load(j * 16), I.i32x4_sub, I.get(R.P00), I.v128_load(j * 16), I.i32x4_add,
+    I.get(R.VS), I.i32x4_mul,
+  ];
+  const light4 = (half, ext, j) => [I.get(half), ext, I.get(R.VA), I.i32x4_mul, window4(j), I.i32x4_gt_u];
+  const threshold = {
+    name: 'threshold',
+    params: ['i32', 'i32', 'i32', 'i32', 'i32', 'i32', 'i32', 'i32'],
+    locals: ['i32', 'i32', 'i32', 'i32', 'i32', 'i32', 'i32', 'i32', 'i32', 'i32', 'v128', 'v128', 'v128', 'v128'],
+    body: [
+      I.get(R.AREA), I.i32x4_splat, I.set(R.VA),
+      I.get(R.SCALE), I.i32x4_splat, I.set(R.VS),
+      // padded gray stride W + 2r, integral stride (W + 2r + 1) * 4
+      I.get(R.W), I.get(R.RAD), I.i32_const(1), I.i32_shl, I.i32_add, I.tee(R.GS),
+      I.i32_const(1), I.i32_add, I.i32_const(4), I.i32_mul, I.set(R.STRIDE),
+      I.get(R.O), I.set(R.PO),
+      I.i32_const(0), I.set(R.Y),
+      I.loop(
+        // P00 = I[y][0], P10 = I[y + 2r + 1][0]; P01/P11 are 2r + 1 columns further on
+        I.get(R.IP), I.get(R.Y), I.get(R.STRIDE), I.i32_mul, I.i32_add, I.tee(R.P00),
+        I.get(R.RAD), I.i32_const(1), I.i32_shl, I.i32_const(1), I.i32_add, I.i32_const(4), I.i32_mul, I.i32_add, I.set(R.P01),
+        I.get(R.P00), I.get(R.RAD), I.i32_const(1), I.i32_shl, I.i32_const(1), I.i32_add, I.get(R.STRIDE), I.i32_mul, I.i32_add, I.set(R.P10),
+        I.get(R.P01), I.get(R.P10), I.get(R.P00), I.i32_sub, I.i32_add, I.set(R.P11),
+        // PG = G[y + r][r]
+        I.get(R.G), I.get(R.Y), I.get(R.RAD), I.i32_add, I.get(R.GS), I.i32_mul, I.i32_add, I.get(R.RAD), I.i32_add, I.set(R.PG),
+        I.get(R.PO), I.get(R.W), I.i32_add, I.set(R.END),
+        I.loop(
+          I.get(R.PG), I.v128_load(), I.tee(R.LO), I.i16x8_extend_high_u8x16, I.set(R.HI),
+          I.get(R.LO), I.i16x8_extend_low_u8x16, I.set(R.LO),
+          I.get(R.PO),
+          light4(R.LO, I.i32x4_extend_low_u16x8, 0), light4(R.LO, I.i32x4_extend_high_u16x8, 1), I.i16x8_narrow_i32x4_s,
+          light4(R.HI, I.i32x4_extend_low_u16x8, 2), light4(R.HI, I.i32x4_extend_high_u16x8, 3), I.i16x8_narrow_i32x4_s,
+          I.i8x16_narrow_i16x8_s, I.v128_store(),
+          [R.P00, R.P01, R.P10, R.P11].map(p => [I.get(p), I.i32_const(64), I.i32_add, I.set(p)]),
+          I.get(R.PG), I.i32_const(16), I.i32_add, I.set(R.PG),
+          I.get(R.PO), I.i32_const(16), I.i32_add, I.tee(R.PO),
+          I.get(R.END), I.i32_lt_u, I.br_if(0),
+        ),
+        I.get(R.END), I.set(R.PO), // the last step may spill into the next row; it is rewritten
+        I.get(R.Y), I.i32_const(1), I.i32_add, I.tee(R.Y),
+        I.get(R.H), I.i32_lt_u, I.br_if(0),
+      ),
+    ],
+  };
+
+  const moduleBytes = () => buildModule({ funcs: [luma, integral, threshold] });
+
+  const align = (n) => (n + 15) & ~15;
+
+  // Edge-replicated copy of gray (w x h) into dst with an r-pixel border.
+  function pad(dst, gray, w, h, r) {
+    const W = w + 2 * r;
+    for (let y = 0; y < h; y++) {
+      const row = (y + r) * W;
+      dst.set(gray.subarray(y * w, y * w + w), row + r);
+      dst.fill(gray[y * w], row, row + r);
+      dst.fill(gray[y * w + w - 1], row + r + w, row + W);
+    }
+    for (let y = 0; y < r; y++) {
+      dst.copyWithin(y * W, r * W, (r + 1) * W);
+      dst.copyWithin((r + h + y) * W, (r + h - 1) * W, (r + h) * W);
+    }
+  }
+
+  /** Window radius in px for a symbol with the given module size (or a whole image). */
+  function radiusFor(module, width, height) {
+    const r = module ? 4 * module : Math.max(width, height) / 16;
+    return Math.max(4, Math.min(64, Math.round(r)));
+  }
+
+  function lumaJs(rgba, n) {
+    const out = new Uint8Array(n);
+    for (let i = 0, j = 0; i < n; i++, j += 4) out[i] = (rgba[j] * 77 + rgba[j + 1] * 150 + rgba[j + 2] * 29) >> 8;
+    return out;
+  }
+
+  function thresholdJs(gray, w, h, { radius = radiusFor(0, w, h), bias = 0.15 } = {}) {
+    const r = radius, W = w + 2 * r, H = h + 2 * r, S = W + 1;
+    const g = new Uint8Array(W * H);
+    pad(g, gray, w, h, r);
+    const sums = new Uint32Array(S * (H + 1));
+    for (let y = 0; y < H; y++) {
+      let s = 0;
+      for (let x = 0; x < W; x++) { s += g[y * W + x]; sums[(y + 1) * S + x + 1] = sums[y * S + x + 1] + s; }
+    }
+    const d = 2 * r + 1, area = d * d, scale = K - Math.round(bias * K), out = new Uint8Array(w * h);
+    for (let y = 0; y < h; y++) {
+      for (let x = 0; x < w; x++) {
+        // The integral wraps past 2^32 on large frames (as the u32 kernel does); the window sum is exact mod 2^32.
+        const sum = (sums[(y + d) * S + x + d] - sums[y * S + x + d] - sums[(y + d) * S + x] + sums[y * S + x]) >>> 0;
+        out[y * w + x] = g[(y + r) * W + x + r] * area * K > sum * scale ? 255 : 0;
+      }
+    }
+    return out;
+  }
+
+  /**
+   * Instantiates the kernel (compiled is an optional WebAssembly.Module). Returns
+   * the scalar versions when WebAssembly SIMD is unavailable.
+   */
+  function create(compiled) {
+    let exports;
+    try {
+      const mod = compiled || new WebAssembly.Module(moduleBytes());
+      exports = new WebAssembly.Instance(mod).exports;
+    } catch {
+      return { simd: false, luma: lumaJs, threshold: thresholdJs };
+    }
+    const memory = exports.memory;
+    const view = (bytes) => {
+      const need = bytes - memory.buffer.byteLength;
+      if (need > 0) memory.grow(Math.ceil(need / 65536));
+      return new Uint8Array(memory.buffer);
+    };
+
+    return {
+      simd: true,
+      /** rgba: RGBA bytes; n: pixel count. Returns a fresh gray Uint8Array(n). */
+      luma(rgba, n) {
+        const src = 0, dst = align(n * 4 + SLACK);
+        const mem = view(dst + align(n + SLACK));
+        mem.set(rgba.subarray(0, n * 4), src);
+        exports.luma(src, dst, dst + n);
+        return mem.slice(dst, dst + n);
+      },
+      /** gray: w x h bytes. Returns a fresh Uint8Array(w * h) of 0 / 255. */
+      threshold(gray, w, h, { radius = radiusFor(0, w, h), bias = 0.15 } = {}) {
+        const r = radius, W = w + 2 * r, H = h + 2 * r, d = 2 * r + 1;
+        const G = 0, Ip = align(W * H + SLACK), O = Ip + align((W + 1) * (H + 1) * 4 + SLACK);
+        const mem = view(O + align(w * h + SLACK));
+        pad(mem, gray, w, h, r);
+        mem.fill(0, Ip, Ip + (W + 1) * 4);
+        exports.integral(G, Ip, W, H);
+        exports.threshold(G, Ip, O, w, h, r, d * d * K, K - Math.round(bias * K));
+        return mem.slice(O, O + w * h);
+      },
+    };
+  }
+
+  return { create, moduleBytes, lumaJs, thresholdJs, radiusFor };
+});
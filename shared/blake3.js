@@ -0,0 +1,257 @@
+/**
+ * GitZipQR — BLAKE3 in WebAssembly SIMD
+ * hash4 compresses four inputs at once, one per i32x4 lane: four 1 KiB chunks
+ * (16 blocks each) or four parent nodes (one 64-byte block each). Message words
+ * are transposed into a 256-byte scratch area per block, so every round reads
+ * its permuted words from fixed offsets. The tree, partial chunks and the root
+ * node run in JS.
+ *
+ * The tree is what makes the hash parallel: subtree(bytes, counter) gives the
+ * chaining value of a 1 MiB-aligned piece, any worker can compute it, and
+ * combine(cvs) folds those values into the digest of the whole input. That
+ * digest is the standard BLAKE3 hash.
+ * hash4Js computes identical results and is the fallback where SIMD is missing.
+ *
+ * Memory: message scratch at 0, chunk CVs at CVS (one per chunk of a subtree), input at IN.
+ * Loads as CommonJS (require) or as a classic script (self.GitZipQRBlake3).
+ */
+(function (root, factory) {
+  if (typeof module === 'object' && module.exports) module.exports = factory(require('./wasm'));
+  else root.GitZipQRBlake3 = factory(root.GitZipQRWasm);
+})(typeof self !== 'undefined' ? self : this, function ({ I, buildModule }) {
+  const IV = [0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19];
+  const CHUNK_START = 1, CHUNK_END = 2, PARENT = 4, ROOT = 8;
+  const CHUNK = 1024, SUBTREE = 1024 * CHUNK; // a subtree is 2^10 chunks
+  const CVS = 256, IN = CVS + (SUBTREE / CHUNK) * 32;
+
+  // SCHEDULE[r][i]: message word used in slot i of round r (round 0 in order, then permuted).
+  const PERMUTE = [2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8];
+  const SCHEDULE = [Array.from({ length: 16 }, (_, i) => i)];
+  for (let r = 1; r < 7; r++) SCHEDULE.push(PERMUTE.map(i => SCHEDULE[r - 1][i]));
+  const G_ORDER = [[0, 4, 8, 12], [1, 5, 9, 13], [2, 6, 10, 14], [3, 7, 11, 15], [0, 5, 10, 15], [1, 6, 11, 12], [2, 7, 8, 13], [3, 4, 9, 14]];
+
+  /* ---- scalar ---- */
+  const v = new Uint32Array(16);
+  const SLOTS = SCHEDULE.flat(), ABCD = G_ORDER.flat();
+  // compress(cv, m, counterLo, counterHi, blockLen, flags, out): out[0..8) = new CV (cv may be out).
+  function compress(cv, m, lo, hi, len, flags, out) {
+    for (let i = 0; i < 8; i++) v[i] = cv[i];
+    for (let i = 0; i < 4; i++) v[8 + i] = IV[i];
+    v[12] = lo; v[13] = hi; v[14] = len; v[15] = flags;
+    for (let k = 0; k < 112; k += 2) {
+      const q = (k & 15) * 2, a = ABCD[q], b = ABCD[q + 1], c = ABCD[q + 2], d = ABCD[q + 3];
+      let va = v[a], vb = v[b], vc = v[c], vd = v[d];
+      va = (va + vb + m[SLOTS[k]]) | 0; vd ^= va; vd = (vd >>> 16) | (vd << 16);
+      vc = (vc + vd) | 0; vb ^= vc; vb = (vb >>> 12) | (vb << 20);
+      va = (va + vb + m[SLOTS[k + 1]]) | 0; vd ^= va; vd = (vd >>> 8) | (vd << 24);
+      vc = (vc + vd) | 0; vb ^= vc; vb = (vb >>> 7) | (vb << 25);
+      v[a] = va; v[b] = vb; v[c] = vc; v[d] = vd;
+    }
+    for (let i = 0; i < 8; i++) out[i] = v[i] ^ v[i + 8];
+    return out;
+  }
+
+  /** Same contract as the hash4 kernel, one lane at a time. */
+  function hash4Js(mem, input, blocks, lo, hi, inc, flags, start, end, output) {
+    const words = new Uint32Array(mem.buffer, mem.byteOffset, mem.byteLength >> 2), cv = new Uint32Array(8);
+    for (let lane = 0; lane < 4; lane++) {
+      cv.set(IV);
+      for (let b = 0; b < blocks; b++) {
+        const m = words.subarray((input + (lane * blocks + b) * 64) >> 2);
+        compress(cv, m, (lo + lane * inc) >>> 0, hi, 64, flags | (b === 0 ? start : 0) | (b === blocks - 1 ? end : 0), cv);
+      }
+      words.set(cv, (output + lane * 32) >> 2);
+    }
+  }
+
+  /* ---- SIMD kernel ---- */
+  // hash4(in, blocks, ctrLo, ctrHi, ctrInc, flags, flagStart, flagEnd, out)
+  const P = { IN: 0, BLOCKS: 1, LO: 2, HI: 3, INC: 4, FLAGS: 5, START: 6, END: 7, OUT: 8 };
+  const L = { B: 9, PTR: 10, STRIDE: 11, F: 12 };
+  const V = Array.from({ length: 16 }, (_, i) => 13 + i), H = Array.from({ length: 8 }, (_, i) => 29 + i);
+  const CTR = 37, R = [38, 39, 40, 41], T = [42, 43, 44, 45];
+  const splat = (x) => Array.from({ length: 16 }, (_, i) => (x >>> ((i & 3) * 8)) & 0xff);
+  const ROTR16 = [2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13];
+  const ROTR8 = [1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12];
+  const rotr = (n) => n === 16 || n === 8
+    ? [I.tee(T[0]), I.get(T[0]), I.i8x16_shuffle(n === 16 ? ROTR16 : ROTR8)]
+    : [I.tee(T[0]), I.i32_const(n), I.i32x4_shr_u, I.get(T[0]), I.i32_const(32 - n), I.i32x4_shl, I.v128_or];
+
+  // rows r[0..3] (one per lane) -> columns written by put(k, vec); in a * b order
+  const transpose = (rows, put) => [
+    I.get(rows[0]), I.get(rows[1]), I.i32x4_shuffle(0, 4, 1, 5), I.set(T[0]),
+    I.get(rows[0]), I.get(rows[1]), I.i32x4_shuffle(2, 6, 3, 7), I.set(T[1]),
+    I.get(rows[2]), I.get(rows[3]), I.i32x4_shuffle(0, 4, 1, 5), I.set(T[2]),
+    I.get(rows[2]), I.get(rows[3]), I.i32x4_shuffle(2, 6, 3, 7), I.set(T[3]),
+    put(0, [I.get(T[0]), I.get(T[2]), I.i32x4_shuffle(0, 1, 4, 5)]),
+    put(1, [I.get(T[0]), I.get(T[2]), I.i32x4_shuffle(2, 3, 6, 7)]),
+    put(2, [I.get(T[1]), I.get(T[3]), I.i32x4_shuffle(0, 1, 4, 5)]),
+    put(3, [I.get(T[1]), I.get(T[3]), I.i32x4_shuffle(2, 3, 6, 7)]),
+  ];
+  const lane = (j) => [I.get(L.PTR), ...(j ? [I.get(L.STRIDE), I.i32_const(j), I.i32_mul, I.i32_add] : [])];
+
+  const g = ([a, b, c, d], x, y) => [
+    I.get(V[a]), I.get(V[b]), I.i32x4_add, I.i32_const(0), I.v128_load(x * 16), I.i32x4_add, I.set(V[a]),
+    I.get(V[d]), I.get(V[a]), I.v128_xor, rotr(16), I.set(V[d]),
+    I.get(V[c]), I.get(V[d]), I.i32x4_add, I.set(V[c]),
+    I.get(V[b]), I.get(V[c]), I.v128_xor, rotr(12), I.set(V[b]),
+    I.get(V[a]), I.get(V[b]), I.i32x4_add, I.i32_const(0), I.v128_load(y * 16), I.i32x4_add, I.set(V[a]),
+    I.get(V[d]), I.get(V[a]), I.v128_xor, rotr(8), I.set(V[d]),
+    I.get(V[c]), I.get(V[d]), I.i32x4_add, I.set(V[c]),
+    I.get(V[b]), I.get(V[c]), I.v128_xor, rotr(7), I.set(V[b]),
+  ];
+
+  const hash4 = {
+    name: 'hash4',
+    params: Array(9).fill('i32'),
+    locals: [...Array(4).fill('i32'), ...Array(33).fill('v128')],
+    body: [
+      I.get(P.BLOCKS), I.i32_const(64), I.i32_mul, I.set(L.STRIDE),
+      I.get(P.LO), I.i32x4_splat, I.v128_const([0, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 3, 0, 0, 0]),
+      I.get(P.INC), I.i32x4_splat, I.i32x4_mul, I.i32x4_add, I.set(CTR),
+      H.map((h, i) => [I.v128_const(splat(IV[i])), I.set(h)]),
+      I.get(P.IN), I.set(L.PTR),
+      I.i32_const(0), I.set(L.B),
+      I.loop(
+        // scratch[w] = word w of this block in all four lanes
+        [0, 1, 2, 3].map(k => [
+          R.map((r, j) => [lane(j), I.v128_load(k * 16), I.set(r)]),
+          transpose(R, (c, vec) => [I.i32_const(0), vec, I.v128_store((4 * k + c) * 16)]),
+        ]),
+        // flags | start (first block) | end (last block)
+        I.get(P.FLAGS),
+        I.get(P.START), I.get(L.B), I.i32_eqz, I.i32_mul, I.i32_or,
+        I.get(P.END), I.get(L.B), I.get(P.BLOCKS), I.i32_const(1), I.i32_sub, I.i32_eq, I.i32_mul, I.i32_or, I.set(L.F),
+        H.map((h, i) => [I.get(h), I.set(V[i])]),
+        [0, 1, 2, 3].map(i => [I.v128_const(splat(IV[i])), I.set(V[8 + i])]),
+        I.get(CTR), I.set(V[12]),
+        I.get(P.HI), I.i32x4_splat, I.set(V[13]),
+        I.v128_const(splat(64)), I.set(V[14]),
+        I.get(L.F), I.i32x4_splat, I.set(V[15]),
+        SCHEDULE.map(s => G_ORDER.map((abcd, k) => g(abcd, s[2 * k], s[2 * k + 1]))),
+        H.map((h, i) => [I.get(V[i]), I.get(V[i + 8]), I.v128_xor, I.set(h)]),
+        I.get(L.PTR), I.i32_const(64), I.i32_add, I.set(L.PTR),
+        I.get(L.B), I.i32_const(1), I.i32_add, I.tee(L.B), I.get(P.BLOCKS), I.i32_lt_u, I.br_if(0),
+      ),
+      // CV of lane j -> out + 32 j
+      [0, 4].map(half => transpose(H.slice(half, half + 4), (j, vec) => [
+        I.get(P.OUT), vec, I.v128_store(j * 32 + half * 4),
+      ])),
+    ],
+  };
+
+  const moduleBytes = () => buildModule({ funcs: [hash4], memoryPages: Math.ceil((IN + SUBTREE) / 65536) });
+
+  const toBytes = (words) => new Uint8Array(Uint32Array.from(words).buffer);
+  const toWords = (bytes) => new Uint32Array(bytes.buffer.slice(bytes.byteOffset, bytes.byteOffset + 32));
+
+  /**
+   * Instantiates the kernel (compiled is an optional WebAssembly.Module). Falls
+   * back to hash4Js when WebAssembly SIMD is unavailable.
+   */
+  function create(compiled) {
+    let mem, kernel, simd = true;
+    try {
+      const exports = new WebAssembly.Instance(compiled || new WebAssembly.Module(moduleBytes())).exports;
+      mem = new Uint8Array(exports.memory.buffer);
+      kernel = exports.hash4;
+    } catch {
+      simd = false;
+      mem = new Uint8Array(IN + SUBTREE);
+      kernel = (...args) => hash4Js(mem, ...args);
+    }
+    const words = new Uint32Array(mem.buffer);
+    const block = new Uint32Array(16), blockBytes = new Uint8Array(block.buffer);
+
+    // Chunk at mem[off, off + len) with the given counter; last block gets `last` flags.
+    function chunkCV(off, len, counter, last, out) {
+      out.set(IV);
+      const blocks = Math.max(1, Math.ceil(len / 64)), hi = Math.floor(counter / 2 ** 32);
+      for (let b = 0; b < blocks; b++) {
+        const n = Math.min(64, len - b * 64);
+        blockBytes.fill(0).set(mem.subarray(off + b * 64, off + b * 64 + n));
+        compress(out, block, counter >>> 0, hi, n, (b === 0 ? CHUNK_START : 0) | (b === blocks - 1 ? CHUNK_END | last : 0), out);
+      }
+      return out;
+    }
+    function parent(left, right, flags, out = new Uint32Array(8)) {
+      block.set(left, 0); block.set(right, 8);
+      return compress(IV, block, 0, 0, 64, PARENT | flags, out);
+    }
+
+    // Chunk CVs of mem[IN, IN + len) -> words at CVS; returns the count.
+    function chunkCVs(len, counter) {
+      const n = Math.ceil(len / CHUNK), full = Math.floor(len / CHUNK), hi = Math.floor(counter / 2 ** 32);
+      let i = 0;
+      if ((counter >>> 0) + full <= 2 ** 32) {
+        for (; i + 4 <= full; i += 4) kernel(IN + i * CHUNK, CHUNK / 64, (counter + i) >>> 0, hi, 1, 0, CHUNK_START, CHUNK_END, CVS + i * 32);
+      }
+      for (; i < n; i++) chunkCV(IN + i * CHUNK, Math.min(CHUNK, len - i * CHUNK), counter + i, 0, words.subarray((CVS >> 2) + i * 8, (CVS >> 2) + i * 8 + 8));
+      return n;
+    }
+    // Pairs CVs level by level until two remain (the last one of an odd level moves up as is).
+    function reduce(n) {
+      while (n > 2) {
+        const pairs = n >> 1;
+        let i = 0;
+        for (; i + 4 <= pairs; i += 4) kernel(CVS + i * 64, 1, 0, 0, 0, PARENT, 0, 0, CVS + i * 32);
+        for (; i < pairs; i++) {
+          const at = (CVS >> 2) + i * 16;
+          parent(words.subarray(at, at + 8), words.subarray(at + 8, at + 16), 0, words.subarray((CVS >> 2) + i * 8));
+        }
+        if (n & 1) words.copyWithin((CVS >> 2) + pairs * 8, (CVS >> 2) + (n - 1) * 8, (CVS >> 2) + n * 8);
+        n = pairs + (n & 1);
+      }
+      return n;
+    }
+    const cv = (i) => words.slice((CVS >> 2) + i * 8, (CVS >> 2) + i * 8 + 8);
+    const load = (bytes) => {
+      if (bytes.length > SUBTREE) throw new Error('BLAKE3: subtree input over 1 MiB');
+      if (!(bytes.buffer === mem.buffer && bytes.byteOffset === IN)) mem.set(bytes, IN);
+      return bytes.length;
+    };
+
+    /** Chaining value of one subtree; counter is its first chunk index (offset / 1024). */
+    function subtree(bytes, counter = 0) {
+      const n = chunkCVs(load(bytes), counter);
+      if (n === 1) return toBytes(cv(0));
+      reduce(n);
+      return toBytes(parent(cv(0), cv(1), 0));
+    }
+
+    /** Digest of the whole input from the CVs of its consecutive 1 MiB subtrees (at least two). */
+    function combine(cvs) {
+      if (cvs.length < 2) throw new Error('BLAKE3: combine needs two or more subtrees');
+      let level = cvs.map(toWords);
+      while (level.length > 2) {
+        const next = [];
+        for (let i = 0; i + 1 < level.length; i += 2) next.push(parent(level[i], level[i + 1], 0));
+        if (level.length & 1) next.push(level[level.length - 1]);
+        level = next;
+      }
+      return toBytes(parent(level[0], level[1], ROOT));
+    }
+
+    /** 32-byte BLAKE3 digest. */
+    function hash(bytes) {
+      if (bytes.length > SUBTREE) {
+        const cvs = [];
+        for (let off = 0; off < bytes.length; off += SUBTREE) cvs.push(subtree(bytes.subarray(off, off + SUBTREE), off / CHUNK));
+        return combine(cvs);
+      }
+      const len = load(bytes);
+      if (len <= CHUNK) return toBytes(chunkCV(IN, len, 0, ROOT, new Uint32Array(8)));
+      reduce(chunkCVs(len, 0));
+      return toBytes(parent(cv(0), cv(1), ROOT));
+    }
+
+    /** View of the input area, for reading a subtree straight into it (e.g. fs.readSync). */
+    const input = (len) => mem.subarray(IN, IN + len);
+
+    return { simd, hash, subtree, combine, input };
+  }
+
+  const toHex = (bytes) => Array.from(bytes, b => b.toString(16).padStart(2, '0')).join('');
+
+  return { CHUNK, SUBTREE, create, moduleBytes, hash4Js, toHex };
+});
@@ -0,0 +1,56 @@
+/**
+ * GitZipQR — QR capacity model (shared by the CLI and the browser)
+ * Byte-mode capacity per version/ECL from the ISO/IEC 18004 codeword tables,
+ * so chunk sizes are computed instead of probed by trial rendering.
+ * Loads as CommonJS (require) or as a classic script (self.GitZipQRCapacity).
+ */
+(function (root, factory) {
+  if (typeof module === 'object' && module.exports) module.exports = factory();
+  else root.GitZipQRCapacity = factory();
+})(typeof self !== 'undefined' ? self : this, function () {
+  const ECLS = ['L', 'M', 'Q', 'H'];
+
+  // Total codewords per version (index 0 unused).
+  const CODEWORDS = [0,
+    26, 44, 70, 100, 134, 172, 196, 242, 292, 346,
+    404, 466, 532, 581, 655, 733, 815, 901, 991, 1085,
+    1156, 1258, 1364, 1474, 1588, 1706, 1828, 1921, 2051, 2185,
+    2323, 2465, 2611, 2761, 2876, 3034, 3196, 3362, 3532, 3706];
+
+  // Error correction codewords per version, columns L, M, Q, H.
+  const EC_CODEWORDS = [
+    7, 10, 13, 17, 10, 16, 22, 28, 15, 26, 36, 44, 20, 36, 52, 64, 26, 48, 72, 88,
+    36, 64, 96, 112, 40, 72, 108, 130, 48, 88, 132, 156, 60, 110, 160, 192, 72, 130, 192, 224,
+    80, 150, 224, 264, 96, 176, 260, 308, 104, 198, 288, 352, 120, 216, 320, 384, 132, 240, 360, 432,
+    144, 280, 408, 480, 168, 308, 448, 532, 180, 338, 504, 588, 196, 364, 546, 650, 224, 416, 600, 700,
+    224, 442, 644, 750, 252, 476, 690, 816, 270, 504, 750, 900, 300, 560, 810, 960, 312, 588, 870, 1050,
+    336, 644, 952, 1110, 360, 700, 1020, 1200, 390, 728, 1050, 1260, 420, 784, 1140, 1350, 450, 812, 1200, 1440,
+    480, 868, 1290, 1530, 510, 924, 1350, 1620, 540, 980, 1440, 1710, 570, 1036, 1530, 1800, 570, 1064, 1590, 1890,
+    600, 1120, 1680, 1980, 630, 1204, 1770, 2100, 660, 1260, 1860, 2220, 720, 1316, 1950, 2310, 750, 1372, 2040, 2430];
+
+  function eclIndex(ecl) {
+    const i = ECLS.indexOf(String(ecl || 'Q').toUpperCase());
+    if (i < 0) throw new Error(`Unknown error correction level: ${ecl}`);
+    return i;
+  }
+
+  function dataCodewords(version, ecl) {
+    if (!(version >= 1 && version <= 40)) throw new Error(`Invalid QR version: ${version}`);
+    return CODEWORDS[version] - EC_CODEWORDS[(version - 1) * 4 + eclIndex(ecl)];
+  }
+
+  // Bytes that fit in one byte-mode segment: 4-bit mode indicator plus an
+  // 8-bit (v1-9) or 16-bit (v10-40) character count precede the data.
+  function byteCapacity(version = 40, ecl = 'Q') {
+    const countBits = version < 10 ? 8 : 16;
+    return Math.floor((dataCodewords(version, ecl) * 8 - 4 - countBits) / 8);
+  }
+
+  // Smallest version whose byte-mode capacity holds `bytes`, or 0 if none does.
+  function minVersion(bytes, ecl = 'Q') {
+    for (let v = 1; v <= 40; v++) if (byteCapacity(v, ecl) >= bytes) return v;
+    return 0;
+  }
+
+  return { ECLS, dataCodewords, byteCapacity, minVersion };
+});
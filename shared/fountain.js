@@ -0,0 +1,254 @@
+/**
+ * GitZipQR — Raptor-style fountain code (shared by the CLI and the browser)
+ * The ciphertext is cut into k equal source blocks (the last one zero-padded).
+ * A precode adds S parity blocks: each source block is XORed into three of
+ * them (the LDPC layout of RFC 5053, S from the same formula). Source and
+ * parity blocks together are the L = k + S intermediate blocks.
+ * Droplet `seed` carries the XOR of the intermediate blocks picked by
+ * neighbors(seed, k). Seeds below k are systematic (just source block `seed`).
+ * Later seeds are repair droplets: a degree from the RFC 5053 LT distribution,
+ * raised to at least 8, over all L blocks, plus two more parity blocks.
+ *
+ * The decoder peels: every droplet left with one unknown block solves it. The
+ * parity relations are extra equations. Once peeling stalls with at least k
+ * droplets in, it runs Gaussian elimination over GF(2) on the equations that
+ * are left. Without the precode, a source block whose own frame was lost and
+ * that no repair droplet covers can never be recovered. With it, that block
+ * is still tied to parity blocks that other droplets cover. Recovery then
+ * needs only a few droplets over k, in any order (test/fountain.test.ts
+ * measures it at a stated loss rate).
+ * Loads as CommonJS (require) or as a classic script (self.GitZipQRFountain).
+ */
+(function (root, factory) {
+  if (typeof module === 'object' && module.exports) module.exports = factory();
+  else root.GitZipQRFountain = factory();
+})(typeof self !== 'undefined' ? self : this, function () {
+  function mulberry32(seed) {
+    let a = seed >>> 0;
+    return function () {
+      a = (a + 0x6d2b79f5) >>> 0;
+      let t = a;
+      t = Math.imul(t ^ (t >>> 15), t | 1);
+      t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+      return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+    };
+  }
+
+  // RFC 5053 degree distribution: [upper bound of f in 0..2^20, degree].
+  const DEGREES = [[10241, 1], [491582, 2], [712794, 3], [831695, 4], [948446, 10], [1032189, 11], [1048576, 40]];
+  // Repair droplets arrive next to mostly-intact systematic frames, so their job is to
+  // cover the few lost blocks, not to keep peeling going: degree at least MIN_DEGREE,
+  // plus PARITY_PICKS parity blocks (as in RaptorQ), so the precode stays well covered.
+  const MIN_DEGREE = 8;
+  const PARITY_PICKS = 2;
+
+  function isPrime(n) {
+    if (n < 2) return false;
+    for (let d = 2; d * d <= n; d++) if (n % d === 0) return false;
+    return true;
+  }
+
+  /** Number of precode parity blocks for k source blocks (RFC 5053 S). */
+  function paritySize(k) {
+    let x = 1;
+    while (x * (x - 1) < 2 * k) x++;
+    let s = Math.ceil(0.01 * k) + x;
+    while (!isPrime(s)) s++;
+    return s;
+  }
+
+  /** The three parity blocks (0..s-1) that source block i is XORed into. */
+  function parityOf(i, s) {
+    const a = 1 + (Math.floor(i / s) % (s - 1));
+    const b = i % s;
+    return [b, (b + a) % s, (b + 2 * a) % s];
+  }
+
+  /** Intermediate block indices (0..k+S-1) XORed into droplet `seed`. */
+  function neighbors(seed, k) {
+    if (seed < k) return [seed];
+    const L = k + paritySize(k);
+    const rng = mulberry32(seed);
+    const f = Math.floor(rng() * 1048576);
+    const d = Math.min(L, Math.max(MIN_DEGREE, DEGREES.find(([bound]) => f < bound)[1]));
+    const picked = new Set();
+    while (picked.size < d) picked.add(Math.floor(rng() * L));
+    // Plus PARITY_PICKS parity blocks (toggled, so a block picked twice drops out like in an XOR).
+    const s = L - k, parity = new Set();
+    while (parity.size < Math.min(PARITY_PICKS, s)) parity.add(k + Math.floor(rng() * s));
+    for (const p of parity) if (!picked.delete(p)) picked.add(p);
+    return [...picked];
+  }
+
+  function xorInto(dst, src) {
+    const n = dst.length & ~3;
+    let i = 0;
+    if (!(dst.byteOffset & 3) && !(src.byteOffset & 3)) {
+      const d = new Int32Array(dst.buffer, dst.byteOffset, n >> 2), s = new Int32Array(src.buffer, src.byteOffset, n >> 2);
+      for (let w = 0; w < d.length; w++) d[w] ^= s[w];
+      i = n;
+    }
+    for (; i < dst.length; i++) dst[i] ^= src[i];
+  }
+
+  /** blockAt(i) -> Uint8Array(blockSize) of source block i (zero-padded). */
+  class Encoder {
+    constructor(k, blockSize, blockAt) {
+      this.k = k;
+      this.s = paritySize(k);
+      this.blockSize = blockSize;
+      this.blockAt = blockAt;
+      this.parity = null; // built on the first repair droplet: one pass over the source
+    }
+
+    block(i) {
+      if (i < this.k) return this.blockAt(i);
+      if (!this.parity) {
+        this.parity = Array.from({ length: this.s }, () => new Uint8Array(this.blockSize));
+        for (let j = 0; j < this.k; j++) {
+          const b = this.blockAt(j);
+          for (const p of parityOf(j, this.s)) xorInto(this.parity[p], b);
+        }
+      }
+      return this.parity[i - this.k];
+    }
+
+    droplet(seed) {
+      const out = new Uint8Array(this.blockSize);
+      for (const i of neighbors(seed, this.k)) xorInto(out, this.block(i));
+      return out;
+    }
+  }
+
+  /**
+   * add() droplets until done, then result(length). finish() runs a last
+   * elimination when the input ends before add() reported done.
+   */
+  class Decoder {
+    constructor(k, blockSize) {
+      this.k = k;
+      this.s = paritySize(k);
+      this.L = k + this.s;
+      this.blockSize = blockSize;
+      this.blocks = new Array(this.L);
+      this.solved = 0; // source blocks known
+      this.seen = new Set();
+      this.waiting = Array.from({ length: this.L }, () => []); // block -> equations still needing it
+      this.live = new Set(); // equations with two or more unknown blocks
+      this.nextElimination = k;
+      // Parity relations: parity block j XOR its source blocks = 0.
+      const members = Array.from({ length: this.s }, (_, j) => [k + j]);
+      for (let i = 0; i < k; i++) for (const j of parityOf(i, this.s)) members[j].push(i);
+      for (const m of members) this._equation(m, new Uint8Array(blockSize));
+    }
+
+    get done() { return this.solved === this.k; }
+
+    /** Returns true once every source block is known. */
+    add(seed, data) {
+      if (this.done || this.seen.has(seed)) return this.done;
+      if (data.length !== this.blockSize) throw new Error('fountain droplet has the wrong size');
+      this.seen.add(seed);
+      this._equation(neighbors(seed, this.k), Uint8Array.from(data));
+      // Elimination costs far more than peeling: try it once k droplets are in, then every 1% more.
+      if (!this.done && this.seen.size >= this.nextElimination) {
+        this._eliminate();
+        this.nextElimination = this.seen.size + Math.max(1, Math.ceil(this.k / 100));
+      }
+      return this.done;
+    }
+
+    finish() {
+      if (!this.done) this._eliminate(true);
+      return this.done;
+    }
+
+    _equation(blocks, data) {
+      const eq = { need: new Set(), data };
+      for (const i of blocks) {
+        if (this.blocks[i]) xorInto(eq.data, this.blocks[i]);
+        else eq.need.add(i);
+      }
+      if (eq.need.size === 1) this._solve(eq.need.values().next().value, eq.data);
+      else if (eq.need.size > 1) {
+        for (const i of eq.need) this.waiting[i].push(eq);
+        this.live.add(eq);
+      }
+    }
+
+    _solve(index, data) {
+      const stack = [[index, data]];
+      while (stack.length) {
+        const [i, block] = stack.pop();
+        if (this.blocks[i]) continue;
+        this.blocks[i] = block;
+        if (i < this.k) this.solved++;
+        for (const eq of this.waiting[i]) {
+          if (!eq.need.delete(i)) continue;
+          xorInto(eq.data, block);
+          if (eq.need.size === 1) {
+            const last = eq.need.values().next().value;
+            eq.need.clear(); // retire it so solving `last` does not XOR the block into itself
+            stack.push([last, eq.data]);
+          }
+          if (eq.need.size < 2) this.live.delete(eq);
+        }
+        this.waiting[i] = null;
+      }
+    }
+
+    // Gauss-Jordan over GF(2) on the equations peeling could not finish; every
+    // block whose row reduces to a single unknown is then handed to _solve().
+    _eliminate(always = false) {
+      const rows = [...this.live];
+      const cols = new Map();
+      const unknowns = [];
+      for (const eq of rows) for (const i of eq.need) if (!cols.has(i)) { cols.set(i, -1); unknowns.push(i); }
+      if (!always && rows.length < unknowns.length) return; // cannot be full rank yet
+      unknowns.sort((a, b) => a - b); // source blocks first, so free columns tend to be parity blocks
+      unknowns.forEach((i, c) => cols.set(i, c));
+      const m = unknowns.length, W = (m + 31) >>> 5;
+      const bits = rows.map((eq) => {
+        const b = new Uint32Array(W);
+        for (const i of eq.need) { const c = cols.get(i); b[c >>> 5] |= 1 << (c & 31); }
+        return b;
+      });
+      const data = rows.map(eq => Uint8Array.from(eq.data));
+      const pivots = [];
+      let rank = 0;
+      for (let c = 0; c < m && rank < rows.length; c++) {
+        const w = c >>> 5, bit = 1 << (c & 31);
+        let p = rank;
+        while (p < rows.length && !(bits[p][w] & bit)) p++;
+        if (p === rows.length) continue;
+        [bits[p], bits[rank]] = [bits[rank], bits[p]];
+        [data[p], data[rank]] = [data[rank], data[p]];
+        const pb = bits[rank], pd = data[rank];
+        for (let r = 0; r < rows.length; r++) {
+          if (r === rank || !(bits[r][w] & bit)) continue;
+          const rb = bits[r];
+          for (let x = 0; x < W; x++) rb[x] ^= pb[x];
+          xorInto(data[r], pd);
+        }
+        pivots.push([c, rank++]);
+      }
+      for (const [c, r] of pivots) {
+        let single = true;
+        for (let x = 0; x < W && single; x++) {
+          const v = bits[r][x];
+          if (v && (x !== c >>> 5 || v !== (1 << (c & 31)) >>> 0)) single = false;
+        }
+        if (single) this._solve(unknowns[c], data[r]);
+      }
+    }
+
+    result(length) {
+      if (!this.done) throw new Error(`fountain incomplete: ${this.solved}/${this.k} blocks`);
+      const out = new Uint8Array(this.k * this.blockSize);
+      for (let i = 0; i < this.k; i++) out.set(this.blocks[i], i * this.blockSize);
+      return out.subarray(0, length);
+    }
+  }
+
+  return { paritySize, neighbors, Encoder, Decoder };
+});
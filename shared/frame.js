@@ -0,0 +1,84 @@
+/**
+ * GitZipQR — chunk frames (shared by the CLI and the browser)
+ * A QR payload is either
+ *   - JSON text: the chunk metadata plus `dataB64` (CLI default, "3.1-inline-only"), or
+ *   - a binary frame carried in byte mode:
+ *       "GZQR" | version u8 | header length u16 (BE) | JSON header | raw chunk bytes
+ *     where the JSON header holds the same metadata as the JSON form minus `dataB64`.
+ * `kcv` (key check value, newer archives) is the first 8 bytes of
+ * HMAC-SHA256(key, KCV_LABEL) in hex: decoders compare it as soon as the key is
+ * derived, so a wrong password fails before the whole archive is scanned.
+ * Loads as CommonJS (require) or as a classic script (self.GitZipQRFrame).
+ */
+(function (root, factory) {
+  if (typeof module === 'object' && module.exports) module.exports = factory();
+  else root.GitZipQRFrame = factory();
+})(typeof self !== 'undefined' ? self : this, function () {
+  const FRAGMENT_TYPE = 'GitZipQR-CHUNK-ENC';
+  const MAGIC = [0x47, 0x5a, 0x51, 0x52]; // "GZQR"
+  const VERSION = 2;
+  const HEADER_BYTES = 7;
+  const KCV_LABEL = 'GitZipQR key check';
+
+  const utf8 = {
+    encode: (s) => new TextEncoder().encode(s),
+    decode: (b) => new TextDecoder().decode(b),
+  };
+
+  function fromBase64(b64) {
+    if (typeof Buffer !== 'undefined') return new Uint8Array(Buffer.from(b64, 'base64'));
+    const binary = atob(b64);
+    const bytes = new Uint8Array(binary.length);
+    for (let i = 0; i < binary.length; i++) bytes[i] = binary.charCodeAt(i);
+    return bytes;
+  }
+
+  function isFrame(bytes) {
+    return !!bytes && bytes.length >= HEADER_BYTES && MAGIC.every((b, i) => bytes[i] === b);
+  }
+
+  /** meta: chunk metadata without dataB64; data: Uint8Array of raw chunk bytes. */
+  function encodeFrame(meta, data) {
+    const head = utf8.encode(JSON.stringify(meta));
+    if (head.length > 0xffff) throw new Error('frame header too large');
+    const out = new Uint8Array(HEADER_BYTES + head.length + data.length);
+    out.set(MAGIC, 0);
+    out[4] = VERSION;
+    out[5] = head.length >> 8; out[6] = head.length & 0xff;
+    out.set(head, HEADER_BYTES);
+    out.set(data, HEADER_BYTES + head.length);
+    return out;
+  }
+
+  function decodeFrame(bytes) {
+    if (!isFrame(bytes)) return null;
+    const version = bytes[4];
+    if (version !== VERSION) throw new Error('Unsupported frame version ' + version);
+    const headLen = (bytes[5] << 8) | bytes[6];
+    const meta = JSON.parse(utf8.decode(bytes.subarray(HEADER_BYTES, HEADER_BYTES + headLen)));
+    return { version, meta, data: bytes.subarray(HEADER_BYTES + headLen) };
+  }
+
+  /** Bytes a binary frame adds on top of its chunk data. */
+  function frameOverhead(meta) {
+    return HEADER_BYTES + utf8.encode(JSON.stringify(meta)).length;
+  }
+
+  /**
+   * Normalizes one decoded QR symbol: `bytes` is the raw byte-mode payload (if
+   * the reader exposes it), `text` its string form. Returns { version, meta, data }
+   * or null when the symbol is not a GitZipQR chunk.
+   */
+  function parsePayload(text, bytes) {
+    const frame = decodeFrame(bytes);
+    if (frame) return frame;
+    if (typeof text !== 'string' || text[0] !== '{') return null;
+    let m;
+    try { m = JSON.parse(text); } catch { return null; }
+    if (!(m && m.type === FRAGMENT_TYPE && typeof m.dataB64 === 'string')) return null;
+    const { dataB64, ...meta } = m;
+    return { version: 0, meta, data: fromBase64(dataB64) };
+  }
+
+  return { FRAGMENT_TYPE, VERSION, KCV_LABEL, isFrame, encodeFrame, decodeFrame, frameOverhead, parsePayload };
+});
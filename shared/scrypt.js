@@ -0,0 +1,143 @@
+/**
+ * GitZipQR — scrypt ROMix in WebAssembly SIMD
+ * scrypt(P, S, N, r, p) = PBKDF2-SHA256(P, ROMix(B_0) || ... || ROMix(B_p-1), 1, dkLen)
+ * with B = PBKDF2-SHA256(P, S, 1, p * 128r). The PBKDF2 steps are cheap and run
+ * on WebCrypto; this module only does ROMix for one lane, so the p lanes can run
+ * on separate workers. Salsa20/8 follows the SSE layout from the reference
+ * implementation (words pre-permuted to diagonals, i * 5 % 16).
+ *
+ * Lane memory: X at 0, Y at 128r, V at 256r (128r * N bytes).
+ * Loads as CommonJS (require) or as a classic script (self.GitZipQRScrypt).
+ */
+(function (root, factory) {
+  if (typeof module === 'object' && module.exports) module.exports = factory(require('./wasm'));
+  else root.GitZipQRScrypt = factory(root.GitZipQRWasm);
+})(typeof self !== 'undefined' ? self : this, function ({ I, buildModule }) {
+  // blockmix(in, out, r) locals
+  const IN = 0, OUT = 1, R = 2, X0 = 3, X1 = 4, X2 = 5, X3 = 6, S0 = 7, S1 = 8, S2 = 9, S3 = 10, TT = 11, IX = 12, P = 13;
+  const X = [X0, X1, X2, X3], S = [S0, S1, S2, S3];
+
+  // dst ^= rotl(a + b, k)
+  const qr = (dst, a, b, k) => [
+    I.get(a), I.get(b), I.i32x4_add, I.tee(TT), I.i32_const(k), I.i32x4_shl, I.get(dst), I.v128_xor,
+    I.get(TT), I.i32_const(32 - k), I.i32x4_shr_u, I.v128_xor, I.set(dst),
+  ];
+  const shuffle = (v, a, b, c, d) => [I.get(v), I.get(v), I.i32x4_shuffle(a, b, c, d), I.set(v)];
+
+  const doubleRound = [
+    qr(X1, X0, X3, 7), qr(X2, X1, X0, 9), qr(X3, X2, X1, 13), qr(X0, X3, X2, 18),
+    shuffle(X1, 3, 0, 1, 2), shuffle(X2, 2, 3, 0, 1), shuffle(X3, 1, 2, 3, 0),
+    qr(X3, X0, X1, 7), qr(X2, X3, X0, 9), qr(X1, X2, X3, 13), qr(X0, X1, X2, 18),
+    shuffle(X1, 1, 2, 3, 0), shuffle(X2, 2, 3, 0, 1), shuffle(X3, 3, 0, 1, 2),
+  ];
+
+  const blockmix = {
+    params: ['i32', 'i32', 'i32'],
+    locals: ['v128', 'v128', 'v128', 'v128', 'v128', 'v128', 'v128', 'v128', 'v128', 'i32', 'i32'],
+    body: [
+      // X = B[2r - 1]
+      I.get(IN), I.get(R), I.i32_const(128), I.i32_mul, I.i32_add, I.i32_const(64), I.i32_sub, I.set(P),
+      X.map((x, k) => [I.get(P), I.v128_load(k * 16), I.set(x)]),
+      I.i32_const(0), I.set(IX),
+      I.loop(
+        // X ^= B[i]; T = X
+        I.get(IN), I.get(IX), I.i32_const(64), I.i32_mul, I.i32_add, I.set(P),
+        X.map((x, k) => [I.get(x), I.get(P), I.v128_load(k * 16), I.v128_xor, I.tee(x), I.set(S[k])]),
+        doubleRound, doubleRound, doubleRound, doubleRound,
+        X.map((x, k) => [I.get(x), I.get(S[k]), I.i32x4_add, I.set(x)]),
+        // Y[i] goes to slot i/2 (even i) or r + i/2 (odd i)
+        I.get(OUT),
+        I.get(IX), I.i32_const(1), I.i32_shr_u,
+        I.get(IX), I.i32_const(1), I.i32_and, I.get(R), I.i32_mul, I.i32_add,
+        I.i32_const(64), I.i32_mul, I.i32_add, I.set(P),
+        X.map((x, k) => [I.get(P), I.get(x), I.v128_store(k * 16)]),
+        I.get(IX), I.i32_const(1), I.i32_add, I.tee(IX),
+        I.get(R), I.i32_const(1), I.i32_shl, I.i32_lt_u, I.br_if(0),
+      ),
+    ],
+  };
+
+  // xor(dst, src, len): dst ^= src, len a multiple of 16
+  const xor = {
+    params: ['i32', 'i32', 'i32'],
+    body: [
+      I.loop(
+        I.get(0), I.get(0), I.v128_load(), I.get(1), I.v128_load(), I.v128_xor, I.v128_store(),
+        I.get(0), I.i32_const(16), I.i32_add, I.set(0),
+        I.get(1), I.i32_const(16), I.i32_add, I.set(1),
+        I.get(2), I.i32_const(16), I.i32_sub, I.tee(2), I.br_if(0),
+      ),
+    ],
+  };
+
+  // smix(r, N): ROMix of the lane at X (offset 0); N must be a power of two
+  const SR = 0, SN = 1, BS = 2, SI = 3, SV = 4, SJ = 5, SY = 6;
+  const smix = {
+    name: 'smix',
+    params: ['i32', 'i32'],
+    locals: ['i32', 'i32', 'i32', 'i32', 'i32'], // bs, i, v, j, y
+    body: [
+      I.get(SR), I.i32_const(128), I.i32_mul, I.tee(BS), I.set(SY),                 // y = bs
+      I.get(BS), I.i32_const(1), I.i32_shl, I.set(SV),                                  // v = 2 * bs
+      I.i32_const(0), I.set(SI),
+      I.loop(
+        I.get(SV), I.get(SI), I.get(BS), I.i32_mul, I.i32_add, I.i32_const(0), I.get(BS), I.memory_copy,
+        I.i32_const(0), I.get(SY), I.get(SR), I.call(0),
+        I.get(SV), I.get(SI), I.i32_const(1), I.i32_add, I.get(BS), I.i32_mul, I.i32_add, I.get(SY), I.get(BS), I.memory_copy,
+        I.get(SY), I.i32_const(0), I.get(SR), I.call(0),
+        I.get(SI), I.i32_const(2), I.i32_add, I.tee(SI), I.get(SN), I.i32_lt_u, I.br_if(0),
+      ),
+      I.i32_const(0), I.set(SI),
+      I.loop(
+        // X ^= V[Integerify(X) mod N]; Y = BlockMix(X); then the same from Y back to X
+        mixStep(0, SY),
+        mixStep(SY, 0),
+        I.get(SI), I.i32_const(2), I.i32_add, I.tee(SI), I.get(SN), I.i32_lt_u, I.br_if(0),
+      ),
+    ],
+  };
+  // from/to: 0 means offset 0 (X), otherwise the local holding Y's offset
+  function mixStep(from, to) {
+    const at = (l) => (l === 0 ? I.i32_const(0) : I.get(l));
+    return [
+      at(from), I.get(BS), I.i32_add, I.i32_const(64), I.i32_sub, I.i32_load(),
+      I.get(SN), I.i32_const(1), I.i32_sub, I.i32_and, I.get(BS), I.i32_mul, I.get(SV), I.i32_add, I.set(SJ),
+      at(from), I.get(SJ), I.get(BS), I.call(1),
+      at(from), at(to), I.get(SR), I.call(0),
+    ];
+  }
+
+  const bytes = () => buildModule({ funcs: [blockmix, xor, smix] });
+
+  function compile() { return WebAssembly.compile(bytes()); }
+  function supported() {
+    try { return WebAssembly.validate(bytes()); } catch { return false; }
+  }
+
+  /** Instantiates a compiled module; romix(lane, N, r) runs ROMix on one 128r-byte lane in place. */
+  function instantiate(module) {
+    const inst = new WebAssembly.Instance(module, {});
+    const memory = inst.exports.memory;
+    return {
+      romix(lane, N, r) {
+        if (N < 2 || (N & (N - 1))) throw new Error('scrypt N must be a power of two');
+        const bs = 128 * r;
+        if (lane.length !== bs) throw new Error('scrypt lane must be 128 * r bytes');
+        const need = Math.ceil(bs * (N + 2) / 65536) - memory.buffer.byteLength / 65536;
+        if (need > 0) memory.grow(need);
+        const words = new Uint32Array(memory.buffer, 0, bs / 4);
+        const view = new DataView(lane.buffer, lane.byteOffset, lane.byteLength);
+        for (let b = 0; b < 2 * r; b++) {
+          for (let i = 0; i < 16; i++) words[b * 16 + i] = view.getUint32((b * 16 + (i * 5) % 16) * 4, true);
+        }
+        inst.exports.smix(r, N);
+        for (let b = 0; b < 2 * r; b++) {
+          for (let i = 0; i < 16; i++) view.setUint32((b * 16 + (i * 5) % 16) * 4, words[b * 16 + i], true);
+        }
+        return lane;
+      },
+    };
+  }
+
+  return { bytes, compile, supported, instantiate };
+});
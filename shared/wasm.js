@@ -0,0 +1,99 @@
+/**
+ * GitZipQR — minimal WebAssembly emitter
+ * Builds small hand-written kernels (scrypt, binarization) as module bytes at
+ * load time, so no wasm toolchain or binary blobs are needed in the repo.
+ * Only the opcodes those kernels use are listed. Each module owns one memory
+ * exported as "memory"; callers grow it as needed.
+ * Loads as CommonJS (require) or as a classic script (self.GitZipQRWasm).
+ */
+(function (root, factory) {
+  if (typeof module === 'object' && module.exports) module.exports = factory();
+  else root.GitZipQRWasm = factory();
+})(typeof self !== 'undefined' ? self : this, function () {
+  const T = { i32: 0x7f, i64: 0x7e, f32: 0x7d, f64: 0x7c, v128: 0x7b };
+
+  function uleb(n) {
+    const out = [];
+    do { let b = n & 0x7f; n >>>= 7; if (n) b |= 0x80; out.push(b); } while (n);
+    return out;
+  }
+  function sleb(n) {
+    const out = [];
+    for (;;) {
+      const b = n & 0x7f; n >>= 7;
+      if ((n === 0 && !(b & 0x40)) || (n === -1 && (b & 0x40))) { out.push(b); return out; }
+      out.push(b | 0x80);
+    }
+  }
+  const str = (s) => [...uleb(s.length), ...Array.from(s, c => c.charCodeAt(0))];
+  const vec = (items) => [...uleb(items.length), ...items.flat()];
+  const section = (id, bytes) => [id, ...uleb(bytes.length), ...bytes];
+  const simd = (code, ...imm) => [0xfd, ...uleb(code), ...imm];
+  const mem = (code, align, offset = 0) => [code, ...uleb(align), ...uleb(offset)];
+
+  // Instruction helpers; each returns a byte array, bodies are nested arrays.
+  const I = {
+    block: (...body) => [0x02, 0x40, ...body.flat(Infinity), 0x0b],
+    loop: (...body) => [0x03, 0x40, ...body.flat(Infinity), 0x0b],
+    br: (d) => [0x0c, ...uleb(d)],
+    br_if: (d) => [0x0d, ...uleb(d)],
+    call: (f) => [0x10, ...uleb(f)],
+    get: (l) => [0x20, ...uleb(l)],
+    set: (l) => [0x21, ...uleb(l)],
+    tee: (l) => [0x22, ...uleb(l)],
+    i32_load: (off = 0) => mem(0x28, 2, off),
+    i32_load8_u: (off = 0) => mem(0x2d, 0, off),
+    i32_store: (off = 0) => mem(0x36, 2, off),
+    i32_store8: (off = 0) => mem(0x3a, 0, off),
+    i32_const: (n) => [0x41, ...sleb(n | 0)],
+    i32_eqz: [0x45], i32_eq: [0x46], i32_ne: [0x47],
+    i32_lt_u: [0x49], i32_gt_u: [0x4b], i32_le_u: [0x4d], i32_ge_u: [0x4f],
+    i32_add: [0x6a], i32_sub: [0x6b], i32_mul: [0x6c], i32_div_u: [0x6e],
+    i32_and: [0x71], i32_or: [0x72], i32_xor: [0x73],
+    i32_shl: [0x74], i32_shr_u: [0x76], i32_rotl: [0x77],
+    memory_copy: [0xfc, ...uleb(10), 0x00, 0x00],
+    memory_fill: [0xfc, ...uleb(11), 0x00],
+    // SIMD (v128)
+    v128_load: (off = 0) => simd(0x00, ...uleb(4), ...uleb(off)),
+    v128_store: (off = 0) => simd(0x0b, ...uleb(4), ...uleb(off)),
+    v128_load32_splat: (off = 0) => simd(0x09, ...uleb(2), ...uleb(off)),
+    v128_const: (bytes) => simd(0x0c, ...bytes),
+    i8x16_shuffle: (lanes) => simd(0x0d, ...lanes),
+    i32x4_shuffle: (a, b, c, d) => simd(0x0d, ...[a, b, c, d].flatMap(l => [l * 4, l * 4 + 1, l * 4 + 2, l * 4 + 3])),
+    i32x4_splat: simd(0x11),
+    v128_and: simd(0x4e), v128_or: simd(0x50), v128_xor: simd(0x51),
+    i16x8_extend_low_u8x16: simd(0x89), i16x8_extend_high_u8x16: simd(0x8a),
+    i32x4_extend_low_u16x8: simd(0xa9), i32x4_extend_high_u16x8: simd(0xaa),
+    i32x4_shl: simd(0xab), i32x4_shr_u: simd(0xad),
+    i32x4_add: simd(0xae), i32x4_sub: simd(0xb1), i32x4_mul: simd(0xb5),
+    i32x4_gt_u: simd(0x3c),
+    i32x4_dot_i16x8_s: simd(0xba),
+    i16x8_narrow_i32x4_s: simd(0x85), i16x8_narrow_i32x4_u: simd(0x86),
+    i8x16_narrow_i16x8_s: simd(0x65), i8x16_narrow_i16x8_u: simd(0x66),
+  };
+
+  /**
+   * funcs: [{ name?, params: ['i32', ...], results: [], locals: ['v128', ...], body: [...] }]
+   * Functions are indexed in order; named ones are exported.
+   */
+  function buildModule({ funcs, memoryPages = 1 }) {
+    const types = funcs.map(f => [0x60, ...vec(f.params.map(t => [T[t]])), ...vec((f.results || []).map(t => [T[t]]))]);
+    const exports = [[...str('memory'), 0x02, 0x00]];
+    funcs.forEach((f, i) => { if (f.name) exports.push([...str(f.name), 0x00, ...uleb(i)]); });
+    const codes = funcs.map((f) => {
+      const locals = (f.locals || []).map(t => [0x01, T[t]]);
+      const body = [...vec(locals), ...f.body.flat(Infinity), 0x0b];
+      return [...uleb(body.length), ...body];
+    });
+    return new Uint8Array([
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+      ...section(1, vec(types)),
+      ...section(3, vec(funcs.map((_, i) => uleb(i)))),
+      ...section(5, vec([[0x00, ...uleb(memoryPages)]])),
+      ...section(7, vec(exports)),
+      ...section(10, vec(codes)),
+    ]);
+  }
+
+  return { I, buildModule };
+});
@@ -0,0 +1,66 @@
+/**
+ * Grayscale PNG and APNG writer/reader (core/apng.ts).
+ */
+const { test, expect } = require('bun:test');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const zlib = require('zlib');
+const { writeApng, readApngFrames, isAnimatedPng, encodeGrayPng, decodePngGray, crc32 } = require('../core/apng');
+
+const W = 37, H = 23;
+const image = (seed) => Uint8Array.from({ length: W * H }, (_, i) => ((i * 29 + seed * 53) ^ (i >> 3)) & 0xff);
+
+test('crc32 matches the PNG check value', () => {
+  expect(crc32(Buffer.from('123456789'))).toBe(0xcbf43926);
+});
+
+test('grayscale PNG round-trips', () => {
+  const gray = image(1);
+  const png = encodeGrayPng(W, H, gray);
+  const out = decodePngGray(png);
+  expect(out.width).toBe(W);
+  expect(out.height).toBe(H);
+  expect(Array.from(out.gray)).toEqual(Array.from(gray));
+});
+
+test('decodePngGray reads gray RGB and rejects colour', () => {
+  const sig = Buffer.from([0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a]);
+  const chunk = (type, data) => {
+    const body = Buffer.concat([Buffer.from(type, 'ascii'), data]);
+    const out = Buffer.alloc(body.length + 8);
+    out.writeUInt32BE(data.length, 0); body.copy(out, 4); out.writeUInt32BE(crc32(body), body.length + 4);
+    return out;
+  };
+  const rgb = (pixel) => {
+    const ihdr = Buffer.alloc(13);
+    ihdr.writeUInt32BE(2, 0); ihdr.writeUInt32BE(1, 4); ihdr[8] = 8; ihdr[9] = 2;
+    const raw = Buffer.from([0, ...pixel(0), ...pixel(1)]);
+    return Buffer.concat([sig, chunk('IHDR', ihdr), chunk('IDAT', zlib.deflateSync(raw)), chunk('IEND', Buffer.alloc(0))]);
+  };
+  expect(Array.from(decodePngGray(rgb(x => [x * 200, x * 200, x * 200])).gray)).toEqual([0, 200]);
+  expect(decodePngGray(rgb(x => [x * 200, 0, 0]))).toBeNull();
+});
+
+test('APNG frames come back as standalone PNGs', async () => {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'gitzipqr-test-'));
+  try {
+    const file = path.join(dir, 'frames.apng'), count = 4;
+    await writeApng(file, count, W, H, 10, (i) => ({ gray: image(i) }));
+    expect(isAnimatedPng(file)).toBe(true);
+    const apng = fs.readFileSync(file);
+    expect(decodePngGray(apng)).toBeNull(); // animated: read per frame
+    const frames = readApngFrames(apng);
+    expect(frames).toHaveLength(count);
+    frames.forEach((png, i) => {
+      const out = decodePngGray(Buffer.from(png));
+      expect(out.width).toBe(W);
+      expect(Array.from(out.gray)).toEqual(Array.from(image(i)));
+    });
+    const still = path.join(dir, 'still.png');
+    fs.writeFileSync(still, encodeGrayPng(W, H, image(0)));
+    expect(isAnimatedPng(still)).toBe(false);
+  } finally {
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+});
@@ -0,0 +1,73 @@
+/**
+ * Per-worker scratch buffers (core/arena.ts): slot isolation across size classes and no stale tails.
+ */
+const { test, expect } = require('bun:test');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const arena = require('../core/arena');
+const { encodeGrayPng, decodePngGray } = require('../core/apng');
+
+// Sizes on both sides of the 64 KiB minimum class and of the next power of two.
+const SIZES = [1, 4095, 65536, 65537, 200000, 131072, 300, 1 << 20];
+
+const overlaps = (a, b) => a.buffer === b.buffer
+  && a.byteOffset < b.byteOffset + b.byteLength && b.byteOffset < a.byteOffset + a.byteLength;
+
+test('views of different slots never share memory, in any order of sizes', () => {
+  const live = new Map();
+  SIZES.forEach((bytes, i) => {
+    for (const slot of ['arena-a', 'arena-b', 'arena-c']) {
+      const view = arena.take(slot, bytes + i);
+      expect(view.length).toBe(bytes + i);
+      view.fill(slot.charCodeAt(6));
+      live.set(slot, view);
+    }
+    const [a, b, c] = [...live.values()];
+    expect(overlaps(a, b) || overlaps(a, c) || overlaps(b, c)).toBe(false);
+    for (const [slot, view] of live) expect(view.every(v => v === slot.charCodeAt(6))).toBe(true);
+  });
+});
+
+test('a slot is reused within its size class and replaced by a larger request', () => {
+  const first = arena.take('arena-grow', 1000);
+  expect(arena.take('arena-grow', 65536).buffer).toBe(first.buffer);
+  const grown = arena.take('arena-grow', 65537);
+  expect(grown.buffer).not.toBe(first.buffer);
+  expect(grown.buffer.byteLength).toBe(131072);
+  expect(arena.take('arena-grow', 10).buffer).toBe(grown.buffer); // never shrinks
+});
+
+test('typed() views are exactly the requested length and zeroed after a larger use', () => {
+  for (const Type of [Uint8Array, Uint8ClampedArray, Int16Array, Float32Array]) {
+    const big = arena.typed('arena-typed', Type, 100000);
+    big.fill(77);
+    const small = arena.typed('arena-typed', Type, 333);
+    expect(small).toHaveLength(333);
+    expect(small.every(v => v === 0)).toBe(true);
+    expect(small.byteOffset % Type.BYTES_PER_ELEMENT).toBe(0);
+  }
+});
+
+test('a smaller file or image after a larger one carries no stale tail bytes', () => {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'gitzipqr-test-'));
+  try {
+    const big = path.join(dir, 'big.bin'), small = path.join(dir, 'small.bin');
+    fs.writeFileSync(big, Buffer.alloc(150000, 0xee));
+    fs.writeFileSync(small, Buffer.from('seven b'));
+    expect(arena.readFile(big, 'arena-file')).toHaveLength(150000);
+    const got = arena.readFile(small, 'arena-file');
+    expect(got.toString()).toBe('seven b');
+
+    // The worker decodes PNGs into the 'gray' slot: a large frame, then a small one.
+    const take = (n) => arena.take('arena-gray', n);
+    const frame = (w, h, f) => Uint8Array.from({ length: w * h }, (_, i) => f(i));
+    const large = frame(700, 500, () => 255), tiny = frame(37, 11, (i) => (i * 7) & 255);
+    expect(decodePngGray(encodeGrayPng(700, 500, large, 1), take).gray).toHaveLength(700 * 500);
+    const out = decodePngGray(encodeGrayPng(37, 11, tiny, 1), take);
+    expect(out.gray).toHaveLength(37 * 11);
+    expect(Array.from(out.gray)).toEqual(Array.from(tiny));
+  } finally {
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+});
@@ -0,0 +1,40 @@
+/**
+ * Adaptive binarization (shared/binarize.js): the SIMD kernel against its scalar twin.
+ */
+const { test, expect } = require('bun:test');
+const binarize = require('../shared/binarize');
+
+const kernel = binarize.create();
+
+// Deterministic noise over a light background with dark blocks, like a scanned page.
+function frame(w, h, seed = 1) {
+  const gray = new Uint8Array(w * h);
+  let s = seed >>> 0;
+  for (let i = 0; i < gray.length; i++) {
+    s = (Math.imul(s, 1664525) + 1013904223) >>> 0;
+    const x = i % w, y = (i / w) | 0;
+    gray[i] = (x >> 5) % 4 === 0 && (y >> 5) % 4 === 0 ? 20 + (s >>> 27) : 224 + (s >>> 27);
+  }
+  return gray;
+}
+
+const firstDiff = (a, b) => a.findIndex((v, i) => v !== b[i]);
+
+test('luma and threshold agree with the scalar versions on a small frame', () => {
+  expect(kernel.simd).toBe(true);
+  const w = 333, h = 217, rgba = new Uint8Array(w * h * 4);
+  for (let i = 0; i < rgba.length; i++) rgba[i] = (i * 37 + (i >> 9)) & 0xff;
+  expect(firstDiff(kernel.luma(rgba, w * h), binarize.lumaJs(rgba, w * h))).toBe(-1);
+  const gray = frame(w, h);
+  for (const radius of [4, 17, 64]) {
+    expect(firstDiff(kernel.threshold(gray, w, h, { radius }), binarize.thresholdJs(gray, w, h, { radius }))).toBe(-1);
+  }
+});
+
+test('threshold agrees when the integral image wraps past 2^32', () => {
+  // (5000 + 2r) x (4000 + 2r) padded pixels averaging ~225 sum to more than 2^32.
+  const w = 5000, h = 4000, gray = frame(w, h, 7);
+  const simd = kernel.threshold(gray, w, h), js = binarize.thresholdJs(gray, w, h);
+  expect(firstDiff(simd, js)).toBe(-1);
+  expect(simd.some(v => v === 0) && simd.some(v => v === 255)).toBe(true);
+});
@@ -0,0 +1,65 @@
+/**
+ * BLAKE3 (shared/blake3.js) against the official test vectors, and hashAll (core/hash.ts).
+ */
+const { test, expect } = require('bun:test');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const crypto = require('crypto');
+const blake3 = require('../shared/blake3');
+const hashing = require('../core/hash');
+
+// Inputs are bytes i % 251 (the BLAKE3 test_vectors.json convention); unkeyed 32-byte hashes.
+const input = (n) => Uint8Array.from({ length: n }, (_, i) => i % 251);
+const VECTORS = [
+  [0, 'af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262'],
+  [1, '2d3adedff11b61f14c886e35afa036736dcd87a74d27b5c1510225d0f592e213'],
+  [1023, '10108970eeda3eb932baac1428c7a2163b0e924c9a9e25b35bba72b28f70bd11'],
+  [1024, '42214739f095a406f3fc83deb889744ac00df831c10daa55189b5d121c855af7'],
+  [1025, 'd00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444'],
+  [2048, 'e776b6028c7cd22a4d0ba182a8bf62205d2ef576467e838ed6f2529b85fba24a'],
+  [2049, '5f4d72f40d7a5f82b15ca2b2e44b1de3c2ef86c426c95c1af0b6879522563030'],
+  [3072, 'b98cb0ff3623be03326b373de6b9095218513e64f1ee2edd2525c7ad1e5cffd2'],
+  [4097, '9b4052b38f1c5fc8b1f9ff7ac7b27cd242487b3d890d15c96a1c25b8aa0fb995'],
+  [8193, 'bab6c09cb8ce8cf459261398d2e7aef35700bf488116ceb94a36d0f5f1b7bc3b'],
+  [16384, 'f875d6646de28985646f34ee13be9a576fd515f76b5b0a26bb324735041ddde4'],
+  [31745, '5c80ce0c3bbe9a6f432a1c6c2ccbde45923d23249386988a30f512d23919eb98'],
+  [102400, 'bc3e3d41a1146b069abffad3c0d44860cf664390afce4d9661f7902e7943e085'],
+];
+const BIG = [3 * blake3.SUBTREE + 5, 'a7bb55bed0c04f58879d1fc1cafb27e14e931f4411fe63baf5b2d5a60357bffb'];
+
+test('WASM SIMD kernel matches the test vectors', () => {
+  const h = blake3.create();
+  for (const [n, hex] of VECTORS) expect(blake3.toHex(h.hash(input(n)))).toBe(hex);
+});
+
+test('scalar fallback matches the test vectors', () => {
+  const h = blake3.create({}); // not a WebAssembly.Module: forces hash4Js
+  expect(h.simd).toBe(false);
+  for (const [n, hex] of VECTORS) expect(blake3.toHex(h.hash(input(n)))).toBe(hex);
+});
+
+test('1 MiB subtrees combine to the standard digest', () => {
+  const [n, hex] = BIG, bytes = input(n), h = blake3.create();
+  expect(blake3.toHex(h.hash(bytes))).toBe(hex);
+  const cvs = [];
+  for (let off = 0; off < n; off += blake3.SUBTREE) cvs.push(h.subtree(bytes.slice(off, off + blake3.SUBTREE), off / blake3.CHUNK));
+  expect(blake3.toHex(h.combine(cvs))).toBe(hex);
+});
+
+test('hashAll returns the archive and chunk digests of a file in one call', async () => {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'gitzipqr-test-'));
+  try {
+    const file = path.join(dir, 'payload.enc'), bytes = input(50000);
+    fs.writeFileSync(file, bytes);
+    const ranges = [[0, 20000], [20000, 20000], [40000, 10000]];
+    const b3 = await hashing.hashAll('blake3', file, bytes.length, ranges);
+    expect(b3.whole).toBe('44e72a003e98fc2a76da16aca79352814c7278629eb36e48d06aa4899f608deb');
+    expect(b3.chunks).toEqual(ranges.map(([off, len]) => hashing.digest('blake3', bytes.subarray(off, off + len))));
+    const sha = await hashing.hashAll('sha256', file, bytes.length, ranges);
+    expect(sha.whole).toBe(crypto.createHash('sha256').update(bytes).digest('hex'));
+    expect(sha.chunks[1]).toBe(crypto.createHash('sha256').update(bytes.subarray(20000, 40000)).digest('hex'));
+  } finally {
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+});
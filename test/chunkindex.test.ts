@@ -0,0 +1,56 @@
+/**
+ * Sidecar chunk index (core/chunkindex.ts): whole and per-shard index files.
+ */
+const { test, expect } = require('bun:test');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const chunkIndex = require('../core/chunkindex');
+const sharding = require('../core/shard');
+
+const TOTAL = 7;
+const header = { fileId: '00112233aabbccdd', name: 'notes', ext: '.txt', total: TOTAL, hashAlg: 'sha256' };
+const entry = (c) => ({ file: `qr-${String(c).padStart(6, '0')}.png`, sha256: String(c).repeat(64).slice(0, 64), chunk: c, part: 0, partTotal: 1, hash: 'ab'.repeat(32) });
+
+function withDir(fn) {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'gitzipqr-test-'));
+  try { return fn(dir); } finally { fs.rmSync(dir, { recursive: true, force: true }); }
+}
+
+function writeShard(dir, i, n) {
+  const [from, to] = sharding.range(TOTAL, { i, n });
+  const entries = Array.from({ length: to - from }, (_, k) => entry(from + k));
+  return chunkIndex.write(dir, { ...header, shard: { i, n }, from, to }, entries);
+}
+
+test('whole index round-trips and plans every chunk', () => withDir((dir) => {
+  const entries = Array.from({ length: TOTAL }, (_, c) => entry(c));
+  expect(path.basename(chunkIndex.write(dir, header, entries))).toBe(chunkIndex.INDEX_NAME);
+  const index = chunkIndex.read(dir);
+  expect(index.header.fileId).toBe(header.fileId);
+  expect(index.entries).toEqual(entries.map(e => ({ ...e })));
+  const p = chunkIndex.plan(dir, index, entries.slice(1).map(e => e.file));
+  expect(p.symbols).toBe(TOTAL);
+  expect(p.missing.map(s => s.chunk)).toEqual([0]);
+}));
+
+test('shard indexes get their own names and merge into one index', () => withDir((dir) => {
+  const names = [0, 1, 2].map(i => path.basename(writeShard(dir, i, 3)));
+  expect(names).toEqual(['gitzipqr.0-of-3.index', 'gitzipqr.1-of-3.index', 'gitzipqr.2-of-3.index']);
+  expect(names.every(chunkIndex.isIndex)).toBe(true);
+  expect(chunkIndex.isIndex('000/qr-000001.png')).toBe(false);
+  const index = chunkIndex.read(dir);
+  expect(index.header.shard).toBeUndefined();
+  expect(index.entries.map(e => e.chunk)).toEqual([0, 1, 2, 3, 4, 5, 6]);
+  const p = chunkIndex.plan(dir, index, index.entries.map(e => e.file));
+  expect(p.missing).toHaveLength(0);
+  expect(p.symbols).toBe(TOTAL);
+}));
+
+test('an incomplete or mixed set of shard indexes is refused', () => withDir((dir) => {
+  writeShard(dir, 0, 3);
+  writeShard(dir, 2, 3);
+  expect(() => chunkIndex.read(dir)).toThrow('shard(s) 1');
+  writeShard(dir, 1, 2);
+  expect(() => chunkIndex.read(dir)).toThrow('different encodes');
+}));
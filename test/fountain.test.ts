@@ -0,0 +1,74 @@
+/**
+ * Raptor-style fountain code (shared/fountain.js): recovery under frame loss and in any order.
+ */
+const { test, expect } = require('bun:test');
+const { Encoder, Decoder, paritySize, neighbors } = require('../shared/fountain');
+
+const BLOCK = 64;
+
+function source(k) {
+  return Array.from({ length: k }, (_, i) => Uint8Array.from({ length: BLOCK }, (_, j) => (i * 131 + j * 7 + (i >> 8)) & 0xff));
+}
+
+// Deterministic LCG, so a failure reproduces.
+function lcg(seed) {
+  let s = seed >>> 0;
+  return () => (s = (Math.imul(s, 1664525) + 1013904223) >>> 0) / 4294967296;
+}
+
+function sameBlocks(decoder, blocks) {
+  const out = decoder.result(blocks.length * BLOCK);
+  return blocks.every((b, i) => b.every((v, j) => v === out[i * BLOCK + j]));
+}
+
+test('seeds below k are systematic; repair droplets stay inside the k + S blocks', () => {
+  const k = 500, L = k + paritySize(k);
+  expect(neighbors(7, k)).toEqual([7]);
+  for (let seed = k; seed < k + 200; seed++) {
+    const n = neighbors(seed, k);
+    expect(new Set(n).size).toBe(n.length);
+    expect(n.every(i => i >= 0 && i < L)).toBe(true);
+  }
+});
+
+// The CLI default: FOUNTAIN_OVERHEAD=0.5, so 1.5k frames, decoded in frame order.
+for (const loss of [0.05, 0.1, 0.2, 0.3]) {
+  test(`k=1000 at overhead 0.5 survives ${loss * 100}% random frame loss`, () => {
+    const k = 1000, blocks = source(k), enc = new Encoder(k, BLOCK, i => blocks[i]);
+    for (let trial = 0; trial < 5; trial++) {
+      const rng = lcg(1000 * trial + loss * 100), dec = new Decoder(k, BLOCK);
+      for (let seed = 0; seed < 1.5 * k && !dec.done; seed++) if (rng() >= loss) dec.add(seed, enc.droplet(seed));
+      expect(dec.finish()).toBe(true);
+      expect(sameBlocks(dec, blocks)).toBe(true);
+    }
+  });
+}
+
+test('any order: about k distinct frames are enough', () => {
+  const k = 300, blocks = source(k), enc = new Encoder(k, BLOCK, i => blocks[i]);
+  const rng = lcg(42), seeds = Array.from({ length: 3 * k }, (_, i) => i);
+  for (let i = seeds.length - 1; i > 0; i--) { const j = Math.floor(rng() * (i + 1)); [seeds[i], seeds[j]] = [seeds[j], seeds[i]]; }
+  const dec = new Decoder(k, BLOCK);
+  let used = 0;
+  for (const seed of seeds) { used++; if (dec.add(seed, enc.droplet(seed))) break; }
+  expect(dec.finish()).toBe(true);
+  expect(used).toBeLessThanOrEqual(Math.ceil(1.05 * k));
+  expect(sameBlocks(dec, blocks)).toBe(true);
+});
+
+test('repair droplets alone rebuild the data', () => {
+  const k = 200, blocks = source(k), enc = new Encoder(k, BLOCK, i => blocks[i]);
+  const dec = new Decoder(k, BLOCK);
+  for (let seed = k; seed < 3 * k && !dec.done; seed++) dec.add(seed, enc.droplet(seed));
+  expect(dec.finish()).toBe(true);
+  expect(dec.seen.size).toBeLessThanOrEqual(Math.ceil(1.1 * k));
+  expect(sameBlocks(dec, blocks)).toBe(true);
+});
+
+test('too few frames: finish() reports failure and result() throws', () => {
+  const k = 100, blocks = source(k), enc = new Encoder(k, BLOCK, i => blocks[i]);
+  const dec = new Decoder(k, BLOCK);
+  for (let seed = 0; seed < k - 10; seed++) dec.add(seed, enc.droplet(seed));
+  expect(dec.finish()).toBe(false);
+  expect(() => dec.result(k * BLOCK)).toThrow();
+});
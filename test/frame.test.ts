@@ -0,0 +1,40 @@
+/**
+ * GZQR binary frames and JSON chunk payloads (shared/frame.js).
+ */
+const { test, expect } = require('bun:test');
+const { FRAGMENT_TYPE, VERSION, isFrame, encodeFrame, decodeFrame, frameOverhead, parsePayload } = require('../shared/frame');
+
+const meta = { type: FRAGMENT_TYPE, fileId: '0123456789abcdef', name: 'notes', ext: '.txt', chunk: 3, total: 9, hash: 'ab'.repeat(32) };
+const data = Uint8Array.from({ length: 300 }, (_, i) => (i * 7) & 0xff);
+
+test('binary frame round-trips metadata and bytes', () => {
+  const bytes = encodeFrame(meta, data);
+  expect(isFrame(bytes)).toBe(true);
+  expect(Array.from(bytes.subarray(0, 5))).toEqual([0x47, 0x5a, 0x51, 0x52, VERSION]);
+  expect(bytes.length).toBe(frameOverhead(meta) + data.length);
+  const f = decodeFrame(bytes);
+  expect(f.version).toBe(VERSION);
+  expect(f.meta).toEqual(meta);
+  expect(Array.from(f.data)).toEqual(Array.from(data));
+});
+
+test('parsePayload accepts binary frames and JSON text', () => {
+  const frame = parsePayload('', encodeFrame(meta, data));
+  expect(frame.meta.chunk).toBe(3);
+  const json = parsePayload(JSON.stringify({ ...meta, dataB64: Buffer.from(data).toString('base64') }), null);
+  expect(json.version).toBe(0);
+  expect(json.meta).toEqual(meta);
+  expect(Array.from(json.data)).toEqual(Array.from(data));
+});
+
+test('parsePayload ignores symbols that are not GitZipQR chunks', () => {
+  expect(parsePayload('https://example.com', null)).toBeNull();
+  expect(parsePayload('{"type":"other","dataB64":""}', null)).toBeNull();
+  expect(parsePayload('{not json', null)).toBeNull();
+});
+
+test('unknown frame versions are rejected', () => {
+  const bytes = encodeFrame(meta, data);
+  bytes[4] = 1;
+  expect(() => decodeFrame(bytes)).toThrow('Unsupported frame version 1');
+});
@@ -0,0 +1,181 @@
+/**
+ * Scaled grayscale JPEG decoder (core/jpeg.ts) against jpeg-js.
+ * The fixtures come from the small baseline encoder below. It covers 4:4:4,
+ * 4:2:0, restart intervals, grayscale, partial MCUs, and Huffman codes longer
+ * than the decoder's 9-bit fast path.
+ */
+const { test, expect } = require('bun:test');
+const jpegjs = require('jpeg-js');
+const { open } = require('../core/jpeg');
+
+const ZIGZAG = [
+  0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5, 12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+  35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51, 58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+];
+
+// Huffman tables as (counts, symbols). DC: 12 categories of 4 bits. AC: EOB, ZRL and
+// run/size, largest size first. The first 120 are 8-bit codes and the last 42 are 12-bit
+// codes, so the common small coefficients (sizes 1-3) take the decoder's slow path.
+const DC_SYMBOLS = Array.from({ length: 12 }, (_, i) => i);
+const AC_SYMBOLS = [0x00, 0xf0];
+for (let s = 10; s >= 1; s--) for (let r = 0; r < 16; r++) AC_SYMBOLS.push((r << 4) | s);
+const counts = (spec) => { const c = new Array(16).fill(0); for (const [len, n] of spec) c[len - 1] = n; return c; };
+const DC_TABLE = { counts: counts([[4, 12]]), symbols: DC_SYMBOLS };
+const AC_TABLE = { counts: counts([[8, 120], [12, 42]]), symbols: AC_SYMBOLS };
+
+function codes({ counts: c, symbols }) {
+  const out = new Map();
+  let code = 0, k = 0;
+  for (let len = 1; len <= 16; len++, code <<= 1) for (let i = 0; i < c[len - 1]; i++) out.set(symbols[k++], [code++, len]);
+  return out;
+}
+
+/**
+ * Baseline JPEG of the planes ([Y] or [Y, Cb, Cr], each (x, y) -> 0..255 at full
+ * size). sampling: [[h, v], ...] per component; restart: MCUs per interval (0: none).
+ */
+function encodeJpeg(width, height, planes, { sampling = planes.map(() => [1, 1]), restart = 0, q = 1 } = {}) {
+  const bytes = [];
+  const u16 = (v) => bytes.push(v >> 8, v & 255);
+  const segment = (marker, body) => { bytes.push(0xff, marker); u16(body.length + 2); bytes.push(...body); };
+  const be = (v) => [v >> 8, v & 255];
+  bytes.push(0xff, 0xd8);
+  segment(0xe0, [0x4a, 0x46, 0x49, 0x46, 0, 1, 1, 0, 0, 1, 0, 1, 0, 0]); // JFIF
+  segment(0xdb, [0, ...new Array(64).fill(q)]);
+  const hmax = Math.max(...sampling.map(s => s[0])), vmax = Math.max(...sampling.map(s => s[1]));
+  segment(0xc0, [8, ...be(height), ...be(width), planes.length, ...planes.flatMap((_, i) => [i + 1, (sampling[i][0] << 4) | sampling[i][1], 0])]);
+  segment(0xc4, [0x00, ...DC_TABLE.counts, ...DC_TABLE.symbols, 0x10, ...AC_TABLE.counts, ...AC_TABLE.symbols]);
+  if (restart) segment(0xdd, be(restart));
+  segment(0xda, [planes.length, ...planes.flatMap((_, i) => [i + 1, 0x00]), 0, 63, 0]);
+
+  const dcCodes = codes(DC_TABLE), acCodes = codes(AC_TABLE);
+  let acc = 0, nacc = 0;
+  const put = (code, len) => {
+    acc = (acc << len) | code; nacc += len;
+    while (nacc >= 8) {
+      const b = (acc >>> (nacc - 8)) & 255;
+      bytes.push(b); if (b === 0xff) bytes.push(0);
+      nacc -= 8; acc &= (1 << nacc) - 1;
+    }
+  };
+  const flush = () => { if (nacc) put((1 << (8 - nacc)) - 1, 8 - nacc); };
+  const category = (v) => { let s = 0; for (let a = Math.abs(v); a; a >>= 1) s++; return s; };
+  const value = (v, s) => (v < 0 ? v + (1 << s) - 1 : v);
+
+  // Component c sample at its own resolution: the mean of the full-size cell it covers, edges replicated.
+  const comps = planes.map((plane, i) => {
+    const [h, v] = sampling[i], sx = hmax / h, sy = vmax / v;
+    const cw = Math.ceil(width * h / hmax), ch = Math.ceil(height * v / vmax);
+    const at = (x, y) => {
+      x = Math.min(x, cw - 1); y = Math.min(y, ch - 1);
+      let s = 0;
+      for (let dy = 0; dy < sy; dy++) for (let dx = 0; dx < sx; dx++) s += plane(Math.min(width - 1, x * sx + dx), Math.min(height - 1, y * sy + dy));
+      return s / (sx * sy);
+    };
+    return { h, v, cw, ch, at, pred: 0 };
+  });
+  const C = (u) => (u ? 1 : Math.SQRT1_2);
+  const block = (c, bx, by) => {
+    const coef = new Array(64);
+    for (let v = 0; v < 8; v++) for (let u = 0; u < 8; u++) {
+      let s = 0;
+      for (let y = 0; y < 8; y++) for (let x = 0; x < 8; x++) {
+        s += (c.at(bx * 8 + x, by * 8 + y) - 128) * Math.cos((2 * x + 1) * u * Math.PI / 16) * Math.cos((2 * y + 1) * v * Math.PI / 16);
+      }
+      coef[v * 8 + u] = Math.round(C(u) * C(v) * s / 4 / q);
+    }
+    const diff = coef[0] - c.pred, s0 = category(diff);
+    c.pred = coef[0];
+    put(...dcCodes.get(s0)); if (s0) put(value(diff, s0), s0);
+    let run = 0;
+    for (let k = 1; k < 64; k++) {
+      const a = coef[ZIGZAG[k]];
+      if (!a) { run++; continue; }
+      while (run > 15) { put(...acCodes.get(0xf0)); run -= 16; }
+      const s = category(a);
+      put(...acCodes.get((run << 4) | s)); put(value(a, s), s);
+      run = 0;
+    }
+    if (run) put(...acCodes.get(0x00));
+  };
+
+  const single = comps.length === 1;
+  const mcusX = single ? Math.ceil(comps[0].cw / 8) : Math.ceil(width / (8 * hmax));
+  const mcusY = single ? Math.ceil(comps[0].ch / 8) : Math.ceil(height / (8 * vmax));
+  for (let m = 0, rst = 0; m < mcusX * mcusY; m++) {
+    if (restart && m && m % restart === 0) {
+      flush(); bytes.push(0xff, 0xd0 + (rst++ & 7));
+      comps.forEach(c => { c.pred = 0; });
+    }
+    const mx = m % mcusX, my = Math.floor(m / mcusX);
+    for (const c of comps) {
+      const hs = single ? 1 : c.h, vs = single ? 1 : c.v;
+      for (let v = 0; v < vs; v++) for (let h = 0; h < hs; h++) block(c, mx * hs + h, my * vs + v);
+    }
+  }
+  flush();
+  bytes.push(0xff, 0xd9);
+  return Buffer.from(bytes);
+}
+
+// A scan-like test card: gradient, dark squares and a 4 px checker, plus some colour.
+// Luma stays within 30..220 and chroma within ±15, so jpeg-js's RGB never clips.
+const W = 75, H = 53;
+const lumaAt = (x, y) => {
+  if (x > 40 && x < 70 && y > 8 && y < 30) return ((x >> 2) + (y >> 2)) & 1 ? 220 : 30;
+  if ((x % 24 < 9) && (y % 20 < 7)) return 30;
+  return 60 + Math.round(150 * (x + y) / (W + H));
+};
+const cbAt = (x) => 128 + Math.round(15 * Math.sin(x / 9));
+const crAt = (x, y) => 128 + Math.round(15 * Math.cos(y / 7));
+
+const FIXTURES = {
+  '4:4:4': () => encodeJpeg(W, H, [lumaAt, cbAt, crAt]),
+  '4:2:0': () => encodeJpeg(W, H, [lumaAt, cbAt, crAt], { sampling: [[2, 2], [1, 1], [1, 1]] }),
+  '4:2:0 with restarts': () => encodeJpeg(W, H, [lumaAt, cbAt, crAt], { sampling: [[2, 2], [1, 1], [1, 1]], restart: 3 }),
+  'gray with restarts': () => encodeJpeg(W, H, [lumaAt], { restart: 5, q: 2 }),
+};
+
+// jpeg-js reference: full-size RGBA -> luma, box-averaged to n/8 scale.
+function reference(buf, n) {
+  const { width, height, data } = jpegjs.decode(buf, { useTArray: true });
+  const luma = (x, y) => { const i = (y * width + x) * 4; return (data[i] * 77 + data[i + 1] * 150 + data[i + 2] * 29) / 256; };
+  const cell = 8 / n, outW = Math.ceil(width * n / 8), outH = Math.ceil(height * n / 8), out = new Float64Array(outW * outH);
+  for (let y = 0; y < outH; y++) for (let x = 0; x < outW; x++) {
+    let s = 0, k = 0;
+    for (let dy = 0; dy < cell && y * cell + dy < height; dy++) for (let dx = 0; dx < cell && x * cell + dx < width; dx++, k++) s += luma(x * cell + dx, y * cell + dy);
+    out[y * outW + x] = s / k;
+  }
+  return { width: outW, height: outH, gray: out };
+}
+
+// Mean / max absolute error allowed per scale. At 8/8 only the IDCT and colour
+// rounding differ. Below that the scaled IDCT is compared with a box filter, and
+// they disagree by tens of levels right at hard edges (the 4 px checker).
+const TOLERANCE = { 8: [1, 6], 4: [5, 40], 2: [7, 40], 1: [1.5, 8] };
+
+for (const [name, make] of Object.entries(FIXTURES)) {
+  test(`${name}: every scale matches jpeg-js`, () => {
+    const buf = make();
+    const j = open(buf);
+    expect(j.width).toBe(W);
+    expect(j.height).toBe(H);
+    for (const n of [8, 4, 2, 1]) {
+      const got = j.render(n), want = reference(buf, n);
+      expect(got.width).toBe(want.width);
+      expect(got.height).toBe(want.height);
+      let sum = 0, max = 0;
+      for (let i = 0; i < got.gray.length; i++) { const d = Math.abs(got.gray[i] - want.gray[i]); sum += d; max = Math.max(max, d); }
+      expect(sum / got.gray.length).toBeLessThanOrEqual(TOLERANCE[n][0]);
+      expect(max).toBeLessThanOrEqual(TOLERANCE[n][1]);
+    }
+  });
+}
+
+test('progressive input throws "not supported" (the jpeg-js fallback)', () => {
+  const buf = Buffer.from(FIXTURES['4:2:0']());
+  const sof = buf.indexOf(Buffer.from([0xff, 0xc0]));
+  buf[sof + 1] = 0xc2; // SOF2: progressive DCT
+  expect(() => open(buf)).toThrow('not supported');
+  expect(() => open(Buffer.from('not a jpeg'))).toThrow('Not a JPEG');
+});
@@ -0,0 +1,81 @@
+/**
+ * Output directory layout (core/layout.ts): sharded placement and the decoder's walk.
+ */
+const { test, expect } = require('bun:test');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const layout = require('../core/layout');
+
+const COUNT = 3000;
+const names = Array.from({ length: COUNT }, (_, i) => `qr-${String(i).padStart(6, '0')}.png`);
+const isIndex = (rel) => rel === 'gitzipqr.index';
+
+async function withDir(fn) {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'gitzipqr-test-'));
+  try {
+    return await fn(dir);
+  } finally {
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+}
+
+// Writes every image through placer(root, fanout, depth), plus an index file at the root.
+function place(root, fanout, depth) {
+  const put = layout.placer(root, fanout, depth);
+  const rels = names.map((name, i) => {
+    const file = put(i, name);
+    fs.writeFileSync(file, String(i));
+    return layout.relative(root, file);
+  });
+  fs.writeFileSync(path.join(root, 'gitzipqr.index'), '');
+  return rels;
+}
+
+// Largest number of entries in any directory below root; the root itself is reported separately.
+function widest(root) {
+  let max = 0;
+  const visit = (dir) => {
+    for (const e of fs.readdirSync(dir, { withFileTypes: true })) if (e.isDirectory()) visit(path.join(dir, e.name));
+    if (dir !== root) max = Math.max(max, fs.readdirSync(dir).length);
+  };
+  visit(root);
+  return { max, top: fs.readdirSync(root).length };
+}
+
+async function walked(root) {
+  const seen = [];
+  for await (const abs of layout.walk(root, isIndex)) seen.push(layout.relative(root, abs));
+  return seen;
+}
+
+test('nested layout: walk() yields every placed file exactly once', () => withDir(async (root) => {
+  const rels = place(root, 10, 3);
+  expect(rels[COUNT - 1]).toBe(`2/9/9/${names[COUNT - 1]}`);
+  expect(rels.every(r => r.split('/').length === 4)).toBe(true);
+  expect(widest(root)).toEqual({ max: 10, top: 4 }); // 0..2 plus the index
+  const seen = await walked(root);
+  expect(seen).toHaveLength(COUNT);
+  expect(seen.sort()).toEqual([...rels].sort());
+  expect((await layout.list(root, isIndex)).sort()).toEqual([...rels].sort());
+}));
+
+test('more images than fanout^(depth+1): the top level grows, lower levels stay within fanout', () => withDir(async (root) => {
+  const rels = place(root, 10, 2);
+  expect(rels[COUNT - 1]).toBe(`29/9/${names[COUNT - 1]}`);
+  expect(new Set(rels).size).toBe(COUNT);
+  expect(widest(root)).toEqual({ max: 10, top: 31 });
+  const seen = await walked(root);
+  expect(seen).toHaveLength(COUNT);
+  expect(seen.sort()).toEqual([...rels].sort());
+}));
+
+test('flat (legacy) layout: every file sits in the root and is walked once', () => withDir(async (root) => {
+  const rels = place(root, 0, 2);
+  expect(rels).toEqual(names);
+  expect(layout.shardDir(root, 12345, 1, 2)).toBe(root);
+  const seen = await walked(root);
+  expect(seen).toHaveLength(COUNT);
+  expect(seen.sort()).toEqual([...names].sort());
+  expect(await layout.list(root, isIndex)).toHaveLength(COUNT);
+}));
@@ -0,0 +1,77 @@
+/**
+ * QR locator for large scans (core/locate.ts): located crops and the full-image fallback.
+ */
+const { test, expect } = require('bun:test');
+const qrcode = require('qrcode');
+const jsQR = require('jsqr');
+const { DETECT_MAX, pyramid, locate, views } = require('../core/locate');
+const symbology = require('../core/symbology');
+
+const TEXT = 'GitZipQR locator test '.repeat(8);
+const symbol = qrcode.create(TEXT, { errorCorrectionLevel: 'M' }).modules;
+
+/**
+ * Gray scan ({ gray, width, height }) of `symbol`, whose top-left corner sits at (x, y).
+ * Modules are `module` px and the symbol is turned by `angle` radians about its center.
+ * The paper is noisy light gray and the ink is dark gray.
+ */
+function scan({ width, height, module, x, y, angle = 0 }) {
+  const gray = new Uint8Array(width * height);
+  for (let i = 0, s = 1; i < gray.length; i++) { s = (s * 1103515245 + 12345) >>> 0; gray[i] = 196 + (s >>> 28); }
+  const half = symbol.size * module / 2, cx = x + half, cy = y + half, r = Math.ceil(half * 1.5);
+  const cos = Math.cos(angle), sin = Math.sin(angle);
+  for (let py = Math.max(0, Math.floor(cy - r)); py < Math.min(height, cy + r); py++) {
+    for (let px = Math.max(0, Math.floor(cx - r)); px < Math.min(width, cx + r); px++) {
+      const dx = px + 0.5 - cx, dy = py + 0.5 - cy;
+      const u = Math.floor((cos * dx + sin * dy + half) / module), v = Math.floor((cos * dy - sin * dx + half) / module);
+      if (u >= 0 && v >= 0 && u < symbol.size && v < symbol.size && symbol.data[v * symbol.size + u]) gray[py * width + px] = 40;
+    }
+  }
+  return { gray, width, height };
+}
+
+const read = (view) => jsQR(view.data, view.width, view.height, { inversionAttempts: view.binary ? 'dontInvert' : 'attemptBoth' });
+
+test('a symbol at an offset in a large scan is cropped and decoded from the first view', () => {
+  const at = { width: 4200, height: 3000, module: 5, x: 2601, y: 1903 };
+  const image = scan(at);
+  expect(Math.max(image.width, image.height)).toBeGreaterThan(DETECT_MAX);
+  const box = locate(pyramid(image.gray, image.width, image.height));
+  const side = symbol.size * at.module;
+  expect(box.x0).toBeLessThanOrEqual(at.x);
+  expect(box.y0).toBeLessThanOrEqual(at.y);
+  expect(box.x1).toBeGreaterThanOrEqual(at.x + side);
+  expect(box.y1).toBeGreaterThanOrEqual(at.y + side);
+  expect((box.x1 - box.x0) * (box.y1 - box.y0)).toBeLessThan(2 * side * side);
+  expect(Math.abs(box.module - at.module)).toBeLessThan(at.module / 4);
+
+  const [first] = views(image);
+  const view = first();
+  expect(view.binary).toBe(true);
+  expect(view.width * view.height).toBeLessThan(image.width * image.height / 50);
+  expect(read(view).data).toBe(TEXT);
+});
+
+test('a slightly rotated symbol with fractional modules is still located and decoded', () => {
+  const at = { width: 3000, height: 4000, module: 7.5, x: 700, y: 2100, angle: 0.2 };
+  const image = scan(at);
+  const box = locate(pyramid(image.gray, image.width, image.height));
+  const cx = at.x + symbol.size * at.module / 2, cy = at.y + symbol.size * at.module / 2;
+  expect(box.x0 < cx && cx < box.x1 && box.y0 < cy && cy < box.y1).toBe(true);
+  const [first, fullCrop] = views(image);
+  expect(read(first()).data).toBe(TEXT);
+  expect(read(fullCrop()).data).toBe(TEXT); // full-resolution crop of the same box
+});
+
+test('a symbol the pyramid misses is still read from the full-resolution image', () => {
+  // At 30 degrees the finder confirmation one level finer fails, so locate() gives up.
+  const image = scan({ width: 2000, height: 2400, module: 6, x: 900, y: 500, angle: 0.52 });
+  expect(locate(pyramid(image.gray, image.width, image.height))).toBeNull();
+  const list = views(image);
+  expect(list).toHaveLength(1);
+  const whole = list[0]();
+  expect(whole.width).toBe(image.width);
+  expect(whole.height).toBe(image.height);
+  const [hit] = symbology.get('qr').read(image);
+  expect(hit.text).toBe(TEXT);
+});
@@ -0,0 +1,35 @@
+/**
+ * WASM SIMD scrypt ROMix (shared/scrypt.js): RFC 7914 vectors and node's scrypt.
+ */
+const crypto = require('crypto');
+const { test, expect } = require('bun:test');
+const scrypt = require('../shared/scrypt');
+
+const kernel = scrypt.instantiate(new WebAssembly.Module(scrypt.bytes()));
+
+// The PBKDF2 steps around ROMix, as the browser worker pool does them.
+function derive(password, salt, N, r, p, dkLen) {
+  const B = crypto.pbkdf2Sync(password, salt, 1, p * 128 * r, 'sha256');
+  for (let i = 0; i < p; i++) kernel.romix(B.subarray(i * 128 * r, (i + 1) * 128 * r), N, r);
+  return crypto.pbkdf2Sync(password, B, 1, dkLen, 'sha256').toString('hex');
+}
+
+test('RFC 7914 test vectors', () => {
+  expect(derive('', '', 16, 1, 1, 64)).toBe(
+    '77d6576238657b203b19ca42c18a0497f16b4844e3074ae8dfdffa3fede21442fcd0069ded0948f8326a753a0fc81f17e8d3e0fb2e0d3628cf35e20c38d18906');
+  expect(derive('password', 'NaCl', 1024, 8, 16, 64)).toBe(
+    'fdbabe1c9d3472007856e7190d01e9fe7c6ad7cbc8237830e77376634b3731622eaf30d92e22a3886ff109279d9830dac727afb94a83ee6d8360cbdfa2cc0640');
+});
+
+test('matches node crypto.scrypt across r and p', () => {
+  for (const [N, r, p] of [[2, 1, 1], [256, 2, 3], [1024, 3, 2]]) {
+    const salt = crypto.randomBytes(16);
+    const want = crypto.scryptSync('correct horse', salt, 32, { N, r, p }).toString('hex');
+    expect(derive('correct horse', salt, N, r, p, 32)).toBe(want);
+  }
+});
+
+test('rejects N that is not a power of two and lanes of the wrong size', () => {
+  expect(() => kernel.romix(new Uint8Array(128), 1000, 1)).toThrow('power of two');
+  expect(() => kernel.romix(new Uint8Array(100), 16, 1)).toThrow('128 * r');
+});
@@ -0,0 +1,79 @@
+/**
+ * Multi-host shards (core/shard.ts): ranges, ownership, seeds and part files.
+ */
+const { test, expect } = require('bun:test');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const sharding = require('../core/shard');
+
+function withDir(fn) {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'gitzipqr-test-'));
+  try { return fn(dir); } finally { fs.rmSync(dir, { recursive: true, force: true }); }
+}
+
+const bytes = (n, seed) => Buffer.from(Array.from({ length: n }, (_, i) => (i * 13 + seed) & 0xff));
+const meta = { type: 'GitZipQR-CHUNK-ENC', fileId: 'f00dcafe12345678', name: 'blob', ext: '.bin' };
+
+function part(dir, i, n, records, fileId = meta.fileId) {
+  return sharding.writePart(dir, { fileId, shard: { i, n }, total: 9, meta: fileId ? meta : null, verified: 0 }, records);
+}
+
+test('parse and fromArgv accept i/n with 0 <= i < n only', () => {
+  expect(sharding.parse('2/5')).toEqual({ i: 2, n: 5 });
+  expect(sharding.fromArgv(['in', 'out', '--shard', '0/1'])).toEqual({ i: 0, n: 1 });
+  expect(sharding.fromArgv(['in'])).toBeNull();
+  for (const bad of ['5/5', '-1/3', '1/0', 'a/b', '']) expect(() => sharding.parse(bad)).toThrow('--shard');
+});
+
+test('ranges partition the items; every path has exactly one owner', () => {
+  for (const [total, n] of [[10, 3], [7, 7], [3, 5], [1000, 16]]) {
+    const ranges = Array.from({ length: n }, (_, i) => sharding.range(total, { i, n }));
+    expect(ranges[0][0]).toBe(0);
+    expect(ranges[n - 1][1]).toBe(total);
+    for (let i = 1; i < n; i++) expect(ranges[i][0]).toBe(ranges[i - 1][1]);
+  }
+  for (const rel of ['qr-000001.png', '000/123/qr-123456.png']) {
+    expect([0, 1, 2, 3].filter(i => sharding.owns(rel, { i, n: 4 }))).toHaveLength(1);
+  }
+});
+
+test('seedFromArgv reads the flag or QR_SHARD_SEED and wants 128 bits of hex', () => {
+  const hex = 'ab'.repeat(32);
+  expect(sharding.seedFromArgv(['--shard-seed', hex], {}).toString('hex')).toBe(hex);
+  expect(sharding.seedFromArgv([], { QR_SHARD_SEED: hex }).length).toBe(32);
+  expect(sharding.seedFromArgv([], {})).toBeNull();
+  expect(() => sharding.seedFromArgv(['--shard-seed', 'ab'.repeat(15)], {})).toThrow('32 hex');
+  expect(() => sharding.seedFromArgv(['--shard-seed', 'xy'.repeat(16)], {})).toThrow('32 hex');
+});
+
+test('part files round-trip header and records', () => withDir((dir) => {
+  const records = [
+    { chunk: 3, part: 0, partTotal: 2, hash: 'aa'.repeat(32), data: bytes(1000, 1) },
+    { chunk: 3, part: 1, partTotal: 2, hash: null, data: bytes(17, 2) },
+    { chunk: 4, part: 0, partTotal: 1, hash: 'bb'.repeat(32), data: bytes(0, 3) },
+  ];
+  const file = part(dir, 1, 3, records);
+  expect(path.basename(file)).toBe(`${meta.fileId}.1-of-3${sharding.PART_EXT}`);
+  const { header, records: back } = sharding.readPart(file);
+  expect(header.meta).toEqual(meta);
+  expect(header.shard).toEqual({ i: 1, n: 3 });
+  expect(back.map(r => [r.chunk, r.part, r.partTotal, r.hash])).toEqual(records.map(r => [r.chunk, r.part, r.partTotal, r.hash]));
+  back.forEach((r, k) => expect(Buffer.compare(Buffer.from(r.data), records[k].data)).toBe(0));
+  fs.appendFileSync(file, 'x');
+  expect(() => sharding.readPart(file)).toThrow('trailing');
+}));
+
+test('readParts wants every shard once, of one archive; empty parts count', () => withDir((dir) => {
+  part(dir, 0, 3, [{ chunk: 0, part: 0, partTotal: 1, hash: 'cc'.repeat(32), data: bytes(50, 4) }]);
+  part(dir, 2, 3, [{ chunk: 8, part: 0, partTotal: 1, hash: 'dd'.repeat(32), data: bytes(50, 5) }]);
+  expect(() => sharding.readParts(dir)).toThrow('1/3');
+  const empty = part(dir, 1, 3, [], null);
+  expect(path.basename(empty)).toBe(`empty.1-of-3${sharding.PART_EXT}`);
+  const parts = sharding.readParts(dir);
+  expect(parts).toHaveLength(3);
+  expect(parts.flatMap(p => p.records)).toHaveLength(2);
+  fs.rmSync(empty);
+  part(dir, 1, 3, [], 'another0archive1');
+  expect(() => sharding.readParts(dir)).toThrow('different archives');
+}));
@@ -0,0 +1,57 @@
+/**
+ * Grid symbology (core/symbology.ts): PNG round-trips of frames and JSON payloads.
+ */
+const { test, expect } = require('bun:test');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const symbology = require('../core/symbology');
+const { decodePngGray } = require('../core/apng');
+const { FRAGMENT_TYPE, encodeFrame, parsePayload } = require('../shared/frame');
+
+const grid = symbology.get('grid');
+const meta = { type: FRAGMENT_TYPE, fileId: 'fedcba9876543210', name: 'photo', ext: '.jpg', chunk: 0, total: 1, sym: 'grid' };
+const data = Uint8Array.from({ length: 5000 }, (_, i) => (i * 151 + (i >> 7)) & 0xff);
+
+async function renderToGray(task) {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'gitzipqr-test-'));
+  try {
+    const outPath = path.join(dir, 'sym.png');
+    await grid.render({ outPath, ...task });
+    return decodePngGray(fs.readFileSync(outPath));
+  } finally {
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+}
+
+test('a binary frame survives grid PNG encode and decode', async () => {
+  const frame = encodeFrame(meta, data);
+  const image = await renderToGray({ data: frame });
+  const [hit] = symbology.read(image);
+  expect(Array.from(hit.bytes)).toEqual(Array.from(frame));
+  const parsed = parsePayload(hit.text, hit.bytes);
+  expect(parsed.meta).toEqual(meta);
+  expect(Array.from(parsed.data)).toEqual(Array.from(data));
+});
+
+test('a JSON payload comes back as text, also from an RGBA image', async () => {
+  const text = JSON.stringify({ ...meta, dataB64: Buffer.from(data.subarray(0, 900)).toString('base64') });
+  const { gray, width, height } = await renderToGray({ text });
+  const rgba = new Uint8ClampedArray(width * height * 4);
+  for (let i = 0; i < gray.length; i++) { rgba.fill(gray[i], 4 * i, 4 * i + 3); rgba[4 * i + 3] = 255; }
+  const [hit] = grid.read({ data: rgba, width, height });
+  expect(hit.text).toBe(text);
+  expect(parsePayload(hit.text, hit.bytes).meta.fileId).toBe(meta.fileId);
+});
+
+test('a damaged grid fails its CRC; payloads over capacity are refused', async () => {
+  const image = await renderToGray({ data });
+  image.gray[image.width + 10] ^= 1;
+  expect(() => grid.read(image)).toThrow('CRC');
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'gitzipqr-test-'));
+  try {
+    await expect(grid.render({ outPath: path.join(dir, 'big.png'), data: new Uint8Array(grid.capacity() + 1) })).rejects.toThrow('too large');
+  } finally {
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+});
@@ -0,0 +1,92 @@
+/**
+ * Canonical ZIP (core/zip.ts) and sharded encodes of directories.
+ */
+const { test, expect } = require('bun:test');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const crypto = require('crypto');
+
+process.env.SCRYPT_N = process.env.SCRYPT_N || '1024';
+process.env.SCRYPT_p = process.env.SCRYPT_p || '1';
+const { writeCanonical } = require('../core/zip');
+const { crc32 } = require('../core/apng');
+const { encode } = require('../core/encode');
+
+const FILES = [
+  ['readme.md', 'hello\n', 0o644],
+  ['bin/run.sh', '#!/bin/sh\necho hi\n', 0o755],
+  ['data/b.bin', crypto.createHash('sha512').update('b').digest(), 0o600],
+  ['data/a.bin', Buffer.alloc(70000, 7), 0o664],
+  ['data/nested/ü.txt', 'unicode name\n', 0o644],
+];
+
+// The same tree, its files created in the given order with a given umask-like mode mask.
+function tree(root, order, mask) {
+  fs.mkdirSync(path.join(root, 'empty'), { recursive: true });
+  for (const k of order) {
+    const [rel, body, mode] = FILES[k], abs = path.join(root, rel);
+    fs.mkdirSync(path.dirname(abs), { recursive: true });
+    fs.writeFileSync(abs, body);
+    fs.chmodSync(abs, mode & mask);
+    fs.utimesSync(abs, new Date(1e12 + k * 1e6), new Date(1e12 + k * 1e6));
+  }
+  return root;
+}
+
+// Minimal reader: central directory -> { name: { mode, data } } via local headers.
+function unzip(buf) {
+  const end = buf.lastIndexOf(Buffer.from([0x50, 0x4b, 0x05, 0x06]));
+  const count = buf.readUInt16LE(end + 10);
+  const out = {};
+  for (let i = 0, at = buf.readUInt32LE(end + 16); i < count; i++) {
+    const size = buf.readUInt32LE(at + 24), n = buf.readUInt16LE(at + 28), crc = buf.readUInt32LE(at + 16);
+    const name = buf.toString('utf8', at + 46, at + 46 + n), local = buf.readUInt32LE(at + 42);
+    const start = local + 30 + buf.readUInt16LE(local + 26) + buf.readUInt16LE(local + 28);
+    const data = buf.subarray(start, start + size);
+    expect(crc32(data)).toBe(crc);
+    out[name] = { mode: buf.readUInt32LE(at + 38) >>> 16, data };
+    at += 46 + n;
+  }
+  return out;
+}
+
+function withDir(fn) {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'gitzipqr-test-'));
+  return Promise.resolve().then(() => fn(dir)).finally(() => fs.rmSync(dir, { recursive: true, force: true }));
+}
+
+test('equal trees zip to equal bytes whatever the creation order, times and modes', () => withDir((dir) => {
+  const a = tree(path.join(dir, 'a'), [0, 1, 2, 3, 4], 0o777), b = tree(path.join(dir, 'b'), [4, 3, 2, 1, 0], 0o700);
+  writeCanonical(a, path.join(dir, 'a.zip'));
+  writeCanonical(b, path.join(dir, 'b.zip'));
+  const za = fs.readFileSync(path.join(dir, 'a.zip'));
+  expect(Buffer.compare(za, fs.readFileSync(path.join(dir, 'b.zip')))).toBe(0);
+  const entries = unzip(za);
+  expect(Object.keys(entries)).toEqual(['bin/', 'bin/run.sh', 'data/', 'data/a.bin', 'data/b.bin', 'data/nested/', 'data/nested/ü.txt', 'empty/', 'readme.md']);
+  expect(entries['bin/run.sh'].mode).toBe(0o100755);
+  expect(entries['data/b.bin'].mode).toBe(0o100644);
+  expect(entries['empty/'].mode).toBe(0o40755);
+  for (const [rel, body] of FILES) expect(Buffer.compare(entries[rel].data, Buffer.from(body))).toBe(0);
+}));
+
+test('symlinks are refused', () => withDir((dir) => {
+  const root = tree(path.join(dir, 't'), [0], 0o777);
+  fs.symlinkSync('readme.md', path.join(root, 'link'));
+  expect(() => writeCanonical(root, path.join(dir, 't.zip'))).toThrow('regular files');
+}));
+
+test('sharded encodes of the same tree on two "hosts" share the fileId', () => withDir(async (dir) => {
+  const seed = crypto.randomBytes(32), shard = { i: 0, n: 2 };
+  const pool = {
+    size: 1,
+    run: async (t) => { fs.writeFileSync(t.outPath, t.text || t.data); return { ok: true, sha256: crypto.createHash('sha256').update(t.text || t.data).digest('hex') }; },
+    destroy: async () => {},
+  };
+  const ids = [];
+  for (const [name, order, mask] of [['h1', [0, 1, 2, 3, 4], 0o777], ['h2', [3, 1, 4, 0, 2], 0o750]]) {
+    const input = tree(path.join(dir, name, 'project'), order, mask);
+    ids.push((await encode(input, path.join(dir, name, 'out'), ['pw-one', 'pw-two'], { pool, shard, shardSeed: seed })).fileId);
+  }
+  expect(ids[0]).toBe(ids[1]);
+}));